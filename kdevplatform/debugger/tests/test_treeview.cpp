@@ -0,0 +1,119 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "test_treeview.h"
+
+#include <debugger/util/treeitem.h>
+#include <debugger/util/treemodel.h>
+#include <debugger/util/treeview.h>
+
+#include <QTest>
+
+#include <algorithm>
+
+QTEST_MAIN(KDevelop::TestTreeView)
+
+using namespace KDevelop;
+
+namespace {
+/// A variable whose children are fetched synchronously, a window at a time
+class TestVariable : public TreeItem
+{
+public:
+    static constexpr int windowSize = 50;
+
+    TestVariable(TreeModel* model, TreeItem* parent, const QString& name, int childCount = 0)
+        : TreeItem(model, parent)
+        , m_childCount(childCount)
+    {
+        setData({name});
+        setHasMoreInitial(childCount > 0);
+    }
+
+    void fetchMoreChildren() override
+    {
+        ++fetchCount;
+        const int first = childItems.size();
+        const int last = std::min(first + windowSize, m_childCount);
+        for (int i = first; i < last; ++i) {
+            appendChild(new TestVariable(model(), this, QStringLiteral("[%1]").arg(i)));
+        }
+        setHasMore(last < m_childCount);
+    }
+
+    int fetchCount = 0;
+
+private:
+    const int m_childCount;
+};
+
+class TestRoot : public TreeItem
+{
+public:
+    explicit TestRoot(TreeModel* model)
+        : TreeItem(model)
+        , array(new TestVariable(model, this, QStringLiteral("array"), 1000))
+    {
+        appendChild(array, true);
+    }
+
+    void fetchMoreChildren() override {}
+
+    TestVariable* const array;
+};
+
+struct TestView
+{
+    TestView()
+        : model({QStringLiteral("Name")})
+        , root(new TestRoot(&model))
+        , view(model)
+    {
+        model.setRootItem(root);
+        view.setModel(&model);
+        // far fewer rows than a window fit
+        view.resize(300, 200);
+        view.show();
+    }
+
+    TreeModel model;
+    TestRoot* const root;
+    AsyncTreeView view;
+};
+}
+
+void TestTreeView::expandFetchesOneWindow()
+{
+    TestView testView;
+    QVERIFY(QTest::qWaitForWindowExposed(&testView.view));
+
+    const QModelIndex arrayIndex = testView.model.index(0, 0);
+    testView.view.expand(arrayIndex);
+    QCOMPARE(testView.root->array->fetchCount, 1);
+
+    // the view lays out the children and checks which of them it shows
+    QTest::qWait(100);
+    QCOMPARE(testView.root->array->fetchCount, 1);
+    QCOMPARE(testView.model.rowCount(arrayIndex), TestVariable::windowSize + 1);
+}
+
+void TestTreeView::scrollToEllipsisFetchesNextWindow()
+{
+    TestView testView;
+    QVERIFY(QTest::qWaitForWindowExposed(&testView.view));
+
+    const QModelIndex arrayIndex = testView.model.index(0, 0);
+    testView.view.expand(arrayIndex);
+    testView.view.scrollToBottom();
+    QTRY_COMPARE(testView.root->array->fetchCount, 2);
+    QCOMPARE(testView.model.rowCount(arrayIndex), 2 * TestVariable::windowSize + 1);
+
+    // the ellipsis of the next window is not shown anymore
+    QTest::qWait(100);
+    QCOMPARE(testView.root->array->fetchCount, 2);
+}
+
+#include "moc_test_treeview.cpp"
@@ -0,0 +1,24 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef KDEVPLATFORM_TEST_TREEVIEW_H
+#define KDEVPLATFORM_TEST_TREEVIEW_H
+
+#include <QObject>
+
+namespace KDevelop
+{
+
+class TestTreeView : public QObject
+{
+Q_OBJECT
+private Q_SLOTS:
+    void expandFetchesOneWindow();
+    void scrollToEllipsisFetchesNextWindow();
+};
+
+}
+#endif // KDEVPLATFORM_TEST_TREEVIEW_H
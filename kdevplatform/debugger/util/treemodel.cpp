@@ -194,6 +194,17 @@ void TreeModel::clicked(const QModelIndex &index)
     item->clicked();
 }
 
+void TreeModel::shown(const QModelIndex &index)
+{
+    if (!index.isValid())
+        return;
+
+    TreeItem* item = itemForIndex(index);
+    TreeItem* parent = item->parent();
+    if (parent && parent->hasMore() && item == parent->ellipsis_)
+        parent->fetchMoreChildren();
+}
+
 bool TreeModel::setData(const QModelIndex& index, const QVariant& value,
                         int role)
 {
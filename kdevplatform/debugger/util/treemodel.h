@@ -32,6 +32,9 @@ public:
     void expanded(const QModelIndex &index);
     void collapsed(const QModelIndex &index);
     void clicked(const QModelIndex &index);
+    /** Called by the view for the items scrolled into view.
+        Fetches the next children if @p index is an ellipsis item.  */
+    void shown(const QModelIndex &index);
 
     void setEditable(bool);
     TreeItem* root() const;
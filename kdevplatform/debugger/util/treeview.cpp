@@ -10,6 +10,8 @@
 
 #include <QGuiApplication>
 #include <QScreen>
+#include <QScrollBar>
+#include <QTimer>
 
 using namespace KDevelop;
 
@@ -17,7 +19,15 @@ AsyncTreeView::AsyncTreeView(TreeModel& treeModel, QWidget* parent)
     : QTreeView(parent)
     , m_treeModel(treeModel)
     , m_autoResizeColumns(true)
+    , m_shownItemsTimer(new QTimer(this))
 {
+    m_shownItemsTimer->setSingleShot(true);
+    m_shownItemsTimer->setInterval(0);
+    connect(m_shownItemsTimer, &QTimer::timeout,
+            this, &AsyncTreeView::slotShownItemsChanged);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged,
+            m_shownItemsTimer, QOverload<>::of(&QTimer::start));
+
     connect (this, &AsyncTreeView::expanded,
              this, &AsyncTreeView::slotExpanded);
     connect (this, &AsyncTreeView::collapsed,
@@ -81,6 +91,30 @@ void AsyncTreeView::slotExpandedDataReady()
     resizeColumnsAutomatically();
 }
 
+void AsyncTreeView::resizeEvent(QResizeEvent* event)
+{
+    QTreeView::resizeEvent(event);
+    m_shownItemsTimer->start();
+}
+
+void AsyncTreeView::rowsInserted(const QModelIndex& parent, int start, int end)
+{
+    QTreeView::rowsInserted(parent, start, end);
+    m_shownItemsTimer->start();
+}
+
+void AsyncTreeView::slotShownItemsChanged()
+{
+    // The children of an item are fetched in windows, the next window only
+    // when the ellipsis item after the last fetched child is scrolled into view.
+    const int viewportHeight = viewport()->height();
+    for (QModelIndex index = indexAt(QPoint(0, 0)); index.isValid(); index = indexBelow(index)) {
+        if (visualRect(index).top() >= viewportHeight)
+            break;
+        m_treeModel.shown(mapViewIndexToTreeModelIndex(index));
+    }
+}
+
 QModelIndex AsyncTreeView::mapViewIndexToTreeModelIndex(const QModelIndex& viewIndex) const
 {
     return viewIndex;
@@ -11,6 +11,8 @@
 
 #include <debugger/debuggerexport.h>
 
+class QTimer;
+
 namespace KDevelop
 {
 class TreeModel;
@@ -31,11 +33,15 @@ class TreeModel;
     protected:
         TreeModel& treeModel();
 
+        void resizeEvent(QResizeEvent* event) override;
+        void rowsInserted(const QModelIndex& parent, int start, int end) override;
+
     private Q_SLOTS:
         void slotExpanded(const QModelIndex &index);
         void slotCollapsed(const QModelIndex &index);
         void slotClicked(const QModelIndex &index);
         void slotExpandedDataReady();
+        void slotShownItemsChanged();
 
     private:
         virtual QModelIndex mapViewIndexToTreeModelIndex(const QModelIndex& viewIndex) const;
@@ -43,6 +49,8 @@ class TreeModel;
 
         TreeModel& m_treeModel;
         bool m_autoResizeColumns;
+        // Collects the changes of the shown items, e.g. while many children are inserted.
+        QTimer* m_shownItemsTimer;
     };
 
 }
@@ -38,10 +38,19 @@
 
 #include "parsejob.h"
 
+#include <algorithm>
+
 using namespace KDevelop;
 
 namespace {
-const bool separateThreadForHighPriority = true;
+/**
+ * @return the count of additional threads that only parse documents with NormalPriority or better,
+ *         e.g. opened and edited ones, such that those never wait behind the parse jobs of a project
+ */
+int reservedHighPriorityThreads(int threads)
+{
+    return std::max(1, threads / 4);
+}
 
 /**
  * Elides string in @p path, e.g. "VEEERY/LONG/PATH" -> ".../LONG/PATH"
@@ -226,6 +235,15 @@ public:
 
     // Non-mutex guarded functions, only call with m_mutex acquired.
 
+    int runningLowPriorityJobs() const
+    {
+        return std::count_if(m_parseJobs.cbegin(), m_parseJobs.cend(), [](const auto* decorator) {
+            const auto* parseJob = dynamic_cast<const ParseJob*>(decorator->job());
+            Q_ASSERT(parseJob);
+            return parseJob->parsePriority() > BackgroundParser::NormalPriority;
+        });
+    }
+
     int currentBestRunningPriority() const
     {
         int bestRunningPriority = BackgroundParser::WorstPriority;
@@ -245,6 +263,7 @@ public:
         // Before starting a new job, first wait for all higher-priority ones to finish.
         // That way, parse job priorities can be used for dependency handling.
         const int bestRunningPriority = currentBestRunningPriority();
+        const bool lowPriorityThreadAvailable = runningLowPriorityJobs() < m_threads;
 
         for (auto it1 = m_documentsForPriority.begin();
              it1 != m_documentsForPriority.end(); ++it1) {
@@ -252,8 +271,8 @@ public:
             if (priority > m_neededPriority)
                 break; //The priority is not good enough to be processed right now
 
-            if (m_parseJobs.count() >= m_threads && priority > BackgroundParser::NormalPriority && !specialParseJob) {
-                break; //The additional parsing thread is reserved for higher priority parsing
+            if (priority > BackgroundParser::NormalPriority && !lowPriorityThreadAvailable) {
+                break; //The additional parsing threads are reserved for higher priority parsing
             }
 
             for (const auto& url : it1.value()) {
@@ -290,9 +309,8 @@ public:
         if (m_shuttingDown)
             return;
 
-        //Only create parse-jobs for up to thread-count * 2 documents, so we don't fill the memory unnecessarily
-        if (m_parseJobs.count() >= m_threads + 1
-            || (m_parseJobs.count() >= m_threads && !separateThreadForHighPriority)) {
+        //Only create parse-jobs for as many documents as there are threads, so we don't fill the memory unnecessarily
+        if (m_parseJobs.count() >= m_threads + reservedHighPriorityThreads(m_threads)) {
             return;
         }
 
@@ -341,9 +359,6 @@ public:
             }
 
             if (decorator) {
-                if (m_parseJobs.count() == m_threads + 1 && !specialParseJob)
-                    specialParseJob = decorator; //This parse-job is allocated into the reserved thread
-
                 m_parseJobs.insert(url, decorator);
                 m_weaver.enqueue(ThreadWeaver::JobPointer(decorator));
             } else {
@@ -531,9 +546,6 @@ public:
     BackgroundParser* m_parser;
     ILanguageController* m_languageController;
 
-    //Current parse-job that is executed in the additional thread
-    QPointer<QObject> specialParseJob;
-
     QTimer m_timer;
     int m_delay = 500;
     int m_threads = 1;
@@ -866,7 +878,7 @@ void BackgroundParser::setThreadCount(int threadCount)
 
     if (d->m_threads != threadCount) {
         d->m_threads = threadCount;
-        d->m_weaver.setMaximumNumberOfThreads(d->m_threads + 1); //1 Additional thread for high-priority parsing
+        d->m_weaver.setMaximumNumberOfThreads(d->m_threads + reservedHighPriorityThreads(d->m_threads));
     }
 }
 
@@ -45,7 +45,7 @@ public:
     enum {
         BestPriority = -10000,  ///Best possible job-priority. No jobs should actually have this.
         NormalPriority = 0,     ///Standard job-priority. This priority is used for parse-jobs caused by document-editing/opening.
-        ///There is an additional parsing-thread reserved for jobs with this and better priority, to improve responsiveness.
+        ///Additional parsing-threads are reserved for jobs with this and better priority, to improve responsiveness.
         InitialParsePriority = 10000, ///Priority used when adding file on project loading
         WorstPriority = 100000  ///Worst possible job-priority.
     };
@@ -124,6 +124,12 @@ int ParseJob::parsePriority() const
     return d->parsePriority;
 }
 
+int ParseJob::priority() const
+{
+    // ThreadWeaver executes queued jobs with a higher priority first
+    return -parsePriority();
+}
+
 bool ParseJob::requiresSequentialProcessing() const
 {
     Q_D(const ParseJob);
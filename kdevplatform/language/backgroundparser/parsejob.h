@@ -65,13 +65,14 @@ public:
     };
     Q_DECLARE_FLAGS(SequentialProcessingFlags, SequentialProcessingFlag)
 
-    ///Sets the priority of this parse job. This is just for the purpose of
-    ///reading it later, and does not affect the actual behaviour in any way.
+    ///Sets the priority of this parse job. It determines the order in which queued jobs are executed.
     void setParsePriority(int priority);
     ///Get the priority of this parse job.
     ///Other than priority(), this will give you the "KDevelop-priority" of the job,
-    ///not the QThread one (which is always zero).
+    ///where a lower value is a better priority.
     int parsePriority() const;
+    ///@return the ThreadWeaver priority of this job, i.e. the negated parsePriority()
+    int priority() const override;
 
     /**
      * _No_ mutexes/locks are allowed to be locked when this is called (except for optionally the foreground lock)
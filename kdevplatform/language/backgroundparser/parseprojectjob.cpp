@@ -15,16 +15,86 @@
 #include <interfaces/icompletionsettings.h>
 
 #include <language/backgroundparser/backgroundparser.h>
+#include <language/duchain/duchain.h>
+#include <language/duchain/duchainlock.h>
+#include <language/duchain/parsingenvironment.h>
 
 #include <KLocalizedString>
 
 #include <QCoreApplication>
+#include <QHash>
 #include <QPointer>
 #include <QSet>
 #include <QTimer>
+#include <QVector>
+
+#include <algorithm>
+#include <vector>
 
 using namespace KDevelop;
 
+namespace {
+// prevent UI-lockup by processing events after some files
+// esp. noticeable when dealing with huge projects
+const int processAfter = 1000;
+
+// Files whose import chain is longer than this are all parsed in the last step.
+const int maxImportLevel = 1000;
+
+using ImportGraph = QHash<IndexedString, QVector<IndexedString>>;
+
+/**
+ * @return the length of the longest chain of imports below each file in @p graph, i.e. the count of
+ *         steps in which the files must be parsed such that all imports of a file are parsed before it
+ * @note An explicit stack is used instead of recursion, the chains of generated headers can be very long.
+ */
+QHash<IndexedString, int> computeImportLevels(const ImportGraph& graph)
+{
+    // -1 marks the files on the current path, include cycles are broken there
+    QHash<IndexedString, int> levels;
+    struct Step
+    {
+        IndexedString file;
+        int nextImport;
+        int level;
+    };
+    std::vector<Step> path;
+
+    for (auto it = graph.cbegin(), end = graph.cend(); it != end; ++it) {
+        if (levels.contains(it.key())) {
+            continue;
+        }
+        levels.insert(it.key(), -1);
+        path.push_back({it.key(), 0, 0});
+
+        while (!path.empty()) {
+            auto& step = path.back();
+            const auto imports = graph.value(step.file);
+            if (step.nextImport < imports.size()) {
+                const auto& import = imports.at(step.nextImport++);
+                const auto levelIt = levels.constFind(import);
+                if (levelIt == levels.cend()) {
+                    levels.insert(import, -1);
+                    path.push_back({import, 0, 0});
+                } else {
+                    step.level = std::max(step.level, std::min(std::max(*levelIt, 0) + 1, maxImportLevel));
+                }
+                continue;
+            }
+
+            const auto finished = path.back();
+            path.pop_back();
+            levels[finished.file] = finished.level;
+            if (!path.empty()) {
+                auto& importer = path.back();
+                importer.level = std::max(importer.level, std::min(finished.level + 1, maxImportLevel));
+            }
+        }
+    }
+    return levels;
+}
+}
+
 class KDevelop::ParseProjectJobPrivate
 {
 public:
@@ -34,6 +104,43 @@ public:
     {
     }
 
+    /**
+     * Collects the imports among the files to parse, as stored in the DUChain by previous parse runs.
+     * @return false if the job was destroyed in the meantime
+     */
+    bool collectImports(ParseProjectJob* job, ImportGraph& graph) const
+    {
+        int processed = 0;
+        auto crashGuard = QPointer<ParseProjectJob>{job};
+        for (const IndexedString& url : filesToParse) {
+            {
+                DUChainReadLocker lock;
+                const auto environmentFiles = DUChain::self()->allEnvironmentFiles(url);
+                for (const auto& file : environmentFiles) {
+                    const auto imports = file->imports();
+                    for (const auto& import : imports) {
+                        const auto importUrl = import->url();
+                        if (importUrl != url && filesToParse.contains(importUrl)) {
+                            auto& fileImports = graph[url];
+                            if (!fileImports.contains(importUrl)) {
+                                fileImports.append(importUrl);
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (++processed == processAfter) {
+                QCoreApplication::processEvents();
+                if (Q_UNLIKELY(!crashGuard) || job->isFinished()) {
+                    return false;
+                }
+                processed = 0;
+            }
+        }
+        return true;
+    }
+
     const bool forceUpdate;
     const bool parseAllProjectSources;
     int fileCountLeftToParse = 0;
@@ -165,15 +272,30 @@ void ParseProjectJob::queueFilesToParse()
         priority = openDocumentPriority;
     }
 
-    // prevent UI-lockup by processing events after some files
-    // esp. noticeable when dealing with huge projects
-    const int processAfter = 1000;
+    // Parse the files in the order of their imports, as known from previous parse runs. Then shared headers
+    // are built once before their importers, instead of all importers blocking on the same header.
+    ImportGraph importGraph;
+    if (!d->collectImports(this, importGraph)) {
+        qCDebug(LANGUAGE) << "Aborting queuing project files to parse."
+                             " This job has been destroyed or killed.";
+        return;
+    }
+    const auto importLevels = computeImportLevels(importGraph);
+    int criticalPathLength = 0;
+    for (auto it = importGraph.cbegin(), end = importGraph.cend(); it != end; ++it) {
+        criticalPathLength = std::max(criticalPathLength, importLevels.value(it.key()) + 1);
+    }
+    qCDebug(LANGUAGE) << "import graph of" << d->filesToParse.size() << "files to parse has" << importGraph.size()
+                      << "importing files, critical path length:" << criticalPathLength;
+
     int processed = 0;
     // guard against reentrancy issues, see also bug 345480
     auto crashGuard = QPointer<ParseProjectJob> {this};
     for (const IndexedString& url : std::as_const(d->filesToParse)) {
+        // the import level only orders the files: an importer that starts while one of its imports is still
+        // being parsed waits for that file alone, and files that do not import it keep every thread busy
         ICore::self()->languageController()->backgroundParser()->addDocument(url, processingLevel,
-                                                                             priority,
+                                                                             priority + importLevels.value(url),
                                                                              this);
         ++processed;
         if (processed == processAfter) {
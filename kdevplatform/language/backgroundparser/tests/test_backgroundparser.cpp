@@ -335,6 +335,37 @@ void TestBackgroundparser::benchmarkDocumentChanges()
     doc->save();
 }
 
+void TestBackgroundparser::benchmarkTimeToFirstHighlight()
+{
+    auto* const parser = ICore::self()->languageController()->backgroundParser();
+
+    // a project that keeps all the threads busy
+    const int projectFiles = 20000;
+    for (int i = 0; i < projectFiles; ++i) {
+        m_jobPlan.addJob(JobPrototype(QUrl::fromLocalFile("/project/file" + QString::number(i) + ".txt"),
+                                      BackgroundParser::InitialParsePriority, ParseJob::IgnoresSequentialProcessing,
+                                      50));
+    }
+    m_jobPlan.addJobsToParser();
+    parser->parseDocuments();
+    QTRY_VERIFY(m_jobPlan.numCreatedJobs() >= parser->threadCount());
+
+    // then the user opens a file
+    const JobPrototype openedFile(QUrl::fromLocalFile(QStringLiteral("/opened_file.txt")),
+                                  BackgroundParser::NormalPriority, ParseJob::IgnoresSequentialProcessing, 10);
+    m_jobPlan.addJob(openedFile);
+    QBENCHMARK_ONCE {
+        parser->addDocument(openedFile.m_url, TopDUContext::Empty, openedFile.m_priority, &m_jobPlan,
+                            openedFile.m_flags, 0);
+        QTRY_VERIFY_WITH_TIMEOUT(m_jobPlan.m_finishedJobs.contains(openedFile.m_url), 5000);
+    }
+    QVERIFY(m_jobPlan.numFinishedJobs() < projectFiles);
+
+    parser->revertAllRequests(&m_jobPlan);
+    parser->abortAllJobs();
+    QVERIFY(parser->waitForIdle());
+}
+
 // see also: https://bugs.kde.org/355100
 void TestBackgroundparser::testNoDeadlockInJobCreation()
 {
@@ -101,6 +101,8 @@ private Q_SLOTS:
 
     void benchmarkDocumentChanges();
 
+    void benchmarkTimeToFirstHighlight();
+
 private:
     JobPlan m_jobPlan;
     TestLanguageSupport* m_langSupport = nullptr;
@@ -163,14 +163,14 @@ public:
 };
 
 // Maps declaration-ids to items
-using CodeModelRepo = ItemRepository<CodeModelRepositoryItem, CodeModelRequestItem>;
+using CodeModelRepo = ItemRepository<CodeModelRepositoryItem, CodeModelRequestItem, true, std::shared_mutex>;
 template <>
 class ItemRepositoryFor<CodeModel>
 {
     friend struct LockedItemRepository;
     static CodeModelRepo& repo()
     {
-        static QMutex mutex;
+        static std::shared_mutex mutex;
         static CodeModelRepo repo(QStringLiteral("Code Model"), &mutex);
         return repo;
     }
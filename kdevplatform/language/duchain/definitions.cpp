@@ -108,7 +108,7 @@ public:
 };
 
 /// Maps declaration-ids to definitions
-using DefinitionsRepo = ItemRepository<DefinitionsItem, DefinitionsRequestItem>;
+using DefinitionsRepo = ItemRepository<DefinitionsItem, DefinitionsRequestItem, true, std::shared_mutex>;
 
 template<>
 class ItemRepositoryFor<Definitions>
@@ -116,7 +116,7 @@ class ItemRepositoryFor<Definitions>
     friend struct LockedItemRepository;
     static DefinitionsRepo& repo()
     {
-        static QMutex mutex;
+        static std::shared_mutex mutex;
         static DefinitionsRepo repo{QStringLiteral("Definition Map"), &mutex};
         return repo;
     }
@@ -66,6 +66,13 @@ const int SOFT_CLEANUP_STEPS = 1;
 // seconds to wait before trying to cleanup the DUChain
 const uint cleanupEverySeconds = 200;
 
+// The intermittent cleanups are skipped while parse jobs are running, which means that nothing is stored during
+// a long indexing run, and a crash loses all of it. After this many skipped cleanups, the next one waits a bit
+// for the parse jobs, so that the duchain is still checkpointed regularly.
+const int maxSkippedCleanups = 2;
+// milliseconds to wait for the parse jobs of a language before a forced intermittent cleanup is skipped anyway
+const int cleanupParseLockTimeout = 5000;
+
 ///Approximate maximum count of top-contexts that are checked during final cleanup
 const uint maxFinalCleanupCheckContexts = 2000;
 const uint minimumFinalCleanupCheckContextsPercentage = 10; //Check at least n% of all top-contexts during cleanup
@@ -352,12 +359,19 @@ private:
                     //Just to make sure the cache is cleared periodically
                     ModificationRevisionSet::clearCache();
 
-                    m_data->doMoreCleanup(SOFT_CLEANUP_STEPS, TryLock);
+                    const auto lockFlag = m_skippedCleanups >= maxSkippedCleanups ? TimedTryLock : TryLock;
+                    if (m_data->doMoreCleanup(SOFT_CLEANUP_STEPS, lockFlag)) {
+                        m_skippedCleanups = 0;
+                    } else {
+                        ++m_skippedCleanups;
+                    }
                 });
             timer.start(cleanupEverySeconds * 1000);
             exec();
         }
         DUChainPrivate* m_data;
+        // only accessed from within this thread
+        int m_skippedCleanups = 0;
     };
 
 public:
@@ -781,21 +795,24 @@ public:
         BlockingLock = 1,
         /// only try to lock and abort on failure, good for the intermittent cleanups
         TryLock = 2,
+        /// like TryLock, but wait up to cleanupParseLockTimeout for the parse jobs of each language
+        TimedTryLock = 3,
     };
     ///@param retries When this is nonzero, then doMoreCleanup will do the specified amount of cycles
     ///doing the cleanup without permanently locking the du-chain. During these steps the consistency
     ///of the disk-storage is not guaranteed, but only few changes will be done during these steps,
     ///so the final step where the duchain is permanently locked is much faster.
-    void doMoreCleanup(int retries = 0, LockFlag lockFlag = BlockingLock)
+    ///@return false if the cleanup was aborted because a language plugin was still parsing, otherwise true
+    bool doMoreCleanup(int retries = 0, LockFlag lockFlag = BlockingLock)
     {
         if (m_cleanupDisabled)
-            return;
+            return true;
 
         //This mutex makes sure that there's never 2 threads at he same time trying to clean up
         QMutexLocker lockCleanupMutex(&cleanupMutex());
 
         if (m_destroyed || m_cleanupDisabled)
-            return;
+            return true;
 
         Q_ASSERT(!instance->lock()->currentThreadHasReadLock() && !instance->lock()->currentThreadHasWriteLock());
         DUChainWriteLocker writeLock(instance->lock());
@@ -814,8 +831,9 @@ public:
 
             //Here we wait for all parsing-threads to stop their processing
             for (const auto language : std::as_const(languages)) {
-                if (lockFlag == TryLock) {
-                    if (!language->parseLock()->tryLockForWrite()) {
+                if (lockFlag == TryLock || lockFlag == TimedTryLock) {
+                    const int timeout = lockFlag == TimedTryLock ? cleanupParseLockTimeout : 0;
+                    if (!language->parseLock()->tryLockForWrite(timeout)) {
                         qCDebug(LANGUAGE) << "Aborting cleanup because language plugin is still parsing:" <<
                             language->name();
                         // some language is still parsing, don't interfere with the cleanup
@@ -823,7 +841,7 @@ public:
                             lock->unlock();
                         }
 
-                        return;
+                        return false;
                     }
                 } else {
                     language->parseLock()->lockForWrite();
@@ -1010,6 +1028,7 @@ unloadContexts:
         // see: https://sourceware.org/bugzilla/show_bug.cgi?id=14827
         malloc_trim(50 * 1024 * 1024);
 #endif
+        return true;
     }
 
     ///Checks whether the information is already loaded.
@@ -10,46 +10,73 @@
 #include "duchainlock.h"
 #include "duchain.h"
 
+#include <QDeadlineTimer>
+#include <QMutex>
 #include <QThread>
 #include <QThreadStorage>
-#include <QElapsedTimer>
+#include <QWaitCondition>
 
 ///@todo Always prefer exactly that lock that is requested by the thread that has the foreground mutex,
 ///           to reduce the amount of UI blocking.
 
-//Microseconds to sleep when waiting for a lock
-const uint uSleepTime = 500;
+namespace {
+/// A timeout of zero means "wait forever", like it always did
+QDeadlineTimer lockDeadline(unsigned int timeout)
+{
+    return timeout ? QDeadlineTimer(qint64(timeout)) : QDeadlineTimer(QDeadlineTimer::Forever);
+}
+}
 
 namespace KDevelop {
 class DUChainLockPrivate
 {
 public:
-    DUChainLockPrivate()
-        : m_writer(nullptr)
-        , m_writerRecursion(0)
-        , m_totalReaderRecursion(0)
-    { }
-
     int ownReaderRecursion() const
     {
         return m_readerRecursion.localData();
     }
 
+    /// Must be called with m_mutex held.
     void changeOwnReaderRecursion(int difference)
     {
         m_readerRecursion.localData() += difference;
         Q_ASSERT(m_readerRecursion.localData() >= 0);
-        m_totalReaderRecursion.fetchAndAddOrdered(difference);
+        m_totalReaderRecursion += difference;
+        Q_ASSERT(m_totalReaderRecursion >= 0);
     }
 
-    ///Holds the writer that currently has the write-lock, or zero. Is protected by m_writerRecursion.
-    QAtomicPointer<QThread> m_writer;
+    /// Must be called with m_mutex held, whenever the lock may have become available to someone else.
+    void wakeWaiters()
+    {
+        if (m_writer.loadRelaxed()) {
+            return;
+        }
+        if (m_waitingWriters) {
+            // prefer writers, readers are held back in lockForRead() as long as a writer is waiting
+            if (m_totalReaderRecursion == 0) {
+                m_writerReleased.wakeOne();
+            }
+        } else {
+            m_readerReleased.wakeAll();
+        }
+    }
 
-    ///How often is the chain write-locked by the writer? This value protects m_writer,
-    ///m_writer may only be changed by the thread that successfully increases this value from 0 to 1
-    QAtomicInt m_writerRecursion;
+    ///Protects all the members below, except for m_readerRecursion which is thread-local anyway
+    QMutex m_mutex;
+    ///Woken up when a waiting writer may be able to acquire the lock
+    QWaitCondition m_writerReleased;
+    ///Woken up when waiting readers may be able to acquire the lock
+    QWaitCondition m_readerReleased;
+
+    ///Holds the writer that currently has the write-lock, or zero.
+    ///Only modified while holding m_mutex, but may be compared against the current thread without it.
+    QAtomicPointer<QThread> m_writer;
+    ///How often is the chain write-locked by the writer?
+    int m_writerRecursion = 0;
     ///How often is the chain read-locked recursively by all readers? Should be sum of all m_readerRecursion values
-    QAtomicInt m_totalReaderRecursion;
+    int m_totalReaderRecursion = 0;
+    ///How many threads are currently blocked in lockForWrite()? New readers queue up behind them.
+    int m_waitingWriters = 0;
 
     QThreadStorage<int> m_readerRecursion;
 };
@@ -65,31 +92,21 @@ bool DUChainLock::lockForRead(unsigned int timeout)
 {
     Q_D(DUChainLock);
 
-    ///Step 1: Increase the own reader-recursion. This will make sure no further write-locks will succeed
-    d->changeOwnReaderRecursion(1);
-
-    QThread* w = d->m_writer.loadAcquire();
-    if (w == nullptr || w == QThread::currentThread()) {
-        //Successful lock: Either there is no writer, or we hold the write-lock by ourselves
-    } else {
-        ///Step 2: Start spinning until there is no writer any more
-
-        QElapsedTimer t;
-        if (timeout) {
-            t.start();
-        }
+    QMutexLocker lock(&d->m_mutex);
 
-        while (d->m_writer.loadAcquire()) {
-            if (!timeout || t.elapsed() < timeout) {
-                QThread::usleep(uSleepTime);
-            } else {
+    // Recursive read locks and read locks taken by the writer itself must never block,
+    // otherwise a waiting writer would dead-lock against us.
+    if (d->ownReaderRecursion() == 0 && d->m_writer.loadRelaxed() != QThread::currentThread()) {
+        const auto deadline = lockDeadline(timeout);
+        while (d->m_writer.loadRelaxed() || d->m_waitingWriters) {
+            if (!d->m_readerReleased.wait(&d->m_mutex, deadline)) {
                 //Fail!
-                d->changeOwnReaderRecursion(-1);
                 return false;
             }
         }
     }
 
+    d->changeOwnReaderRecursion(1);
     return true;
 }
 
@@ -97,7 +114,12 @@ void DUChainLock::releaseReadLock()
 {
     Q_D(DUChainLock);
 
+    QMutexLocker lock(&d->m_mutex);
+
     d->changeOwnReaderRecursion(-1);
+    if (d->m_totalReaderRecursion == 0) {
+        d->wakeWaiters();
+    }
 }
 
 bool DUChainLock::currentThreadHasReadLock()
@@ -115,41 +137,29 @@ bool DUChainLock::lockForWrite(uint timeout)
 
     Q_ASSERT(d->ownReaderRecursion() == 0);
 
+    QMutexLocker lock(&d->m_mutex);
+
     if (d->m_writer.loadRelaxed() == QThread::currentThread()) {
         //We already hold the write lock, just increase the recursion count and return
-        d->m_writerRecursion.fetchAndAddRelaxed(1);
+        ++d->m_writerRecursion;
         return true;
     }
 
-    QElapsedTimer t;
-    if (timeout) {
-        t.start();
-    }
-
-    while (1) {
-        //Try acquiring the write-lcok
-        if (d->m_totalReaderRecursion.loadRelaxed() == 0 && d->m_writerRecursion.testAndSetOrdered(0, 1)) {
-            //Now we can be sure that there is no other writer, as we have increased m_writerRecursion from 0 to 1
-            d->m_writer = QThread::currentThread();
-            if (d->m_totalReaderRecursion.loadRelaxed() == 0) {
-                //There is still no readers, we have successfully acquired a write-lock
-                return true;
-            } else {
-                //There may be readers.. we have to continue spinning
-                d->m_writer = nullptr;
-                d->m_writerRecursion = 0;
-            }
-        }
-
-        if (!timeout || t.elapsed() < timeout) {
-            QThread::usleep(uSleepTime);
-        } else {
-            //Fail!
+    const auto deadline = lockDeadline(timeout);
+    ++d->m_waitingWriters;
+    while (d->m_writer.loadRelaxed() || d->m_totalReaderRecursion) {
+        if (!d->m_writerReleased.wait(&d->m_mutex, deadline)) {
+            //Fail! Readers may have been held back by us, so give them a chance to continue
+            --d->m_waitingWriters;
+            d->wakeWaiters();
             return false;
         }
     }
+    --d->m_waitingWriters;
 
-    return false;
+    d->m_writer.storeRelaxed(QThread::currentThread());
+    d->m_writerRecursion = 1;
+    return true;
 }
 
 void DUChainLock::releaseWriteLock()
@@ -158,14 +168,12 @@ void DUChainLock::releaseWriteLock()
 
     Q_ASSERT(currentThreadHasWriteLock());
 
-    //The order is important here, m_writerRecursion protects m_writer
+    QMutexLocker lock(&d->m_mutex);
 
-    //TODO: could testAndSet here
-    if (d->m_writerRecursion.loadRelaxed() == 1) {
-        d->m_writer = nullptr;
-        d->m_writerRecursion = 0;
-    } else {
-        d->m_writerRecursion.fetchAndAddOrdered(-1);
+    if (--d->m_writerRecursion == 0) {
+        d->m_writer.storeRelaxed(nullptr);
+        // if we still hold read locks, waiting writers get woken up by the last releaseReadLock()
+        d->wakeWaiters();
     }
 }
 
@@ -37,6 +37,10 @@ class DUChainLockPrivate;
 
 /**
  * Customized read/write locker for the definition-use chain.
+ *
+ * Waiting threads block until they are woken up by the release of the lock.
+ * Writers are preferred: as soon as a writer is waiting, new readers queue up behind it,
+ * so that a steady stream of readers cannot starve the writers.
  */
 class KDEVPLATFORMLANGUAGE_EXPORT DUChainLock
 {
@@ -51,7 +55,7 @@ public:
      * or timeout
      *
      * Any number of read locks can be acquired at once, but not while
-     * there is a write lock.  Read locks are recursive.
+     * there is a write lock or a thread waiting for one.  Read locks are recursive.
      * That means that a thread can acquire a read-lock when it already
      * has an arbitrary count of read- and write-locks acquired.
      * @param timeout A locking timeout in milliseconds. If it is reached, and the lock could not be acquired, false is returned. If null, the default timeout is used.
@@ -70,12 +74,12 @@ public:
 
     /**
      * Acquires a write lock. Will not return until the lock is acquired
-     * or timeout is reached (10 seconds).
+     * or timeout is reached.
      *
      * Write locks are recursive. That means that they can by acquired by threads
      * that already have an arbitrary count of write-locks acquired.
      *
-     * @param timeout A timeout in milliseconds. If zero, the default-timeout is used(Currently 10 seconds).
+     * @param timeout A timeout in milliseconds. If zero, this waits until the lock is acquired.
      *
      * \warning Write-locks can NOT be acquired by threads that already have a read-lock.
      */
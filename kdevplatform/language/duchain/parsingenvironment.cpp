@@ -390,6 +390,23 @@ void ParsingEnvironmentFile::setModificationRevision(const KDevelop::Modificatio
     d_func_dynamic()->m_allModificationRevisions.addModificationRevision(d_func()->m_url, d_func()->m_modificationTime);
 }
 
+bool ParsingEnvironmentFile::replaceModificationRevision(const IndexedString& url,
+                                                         const ModificationRevision& oldRevision,
+                                                         const ModificationRevision& newRevision)
+{
+    ENSURE_WRITE_LOCKED
+
+    if (url == d_func()->m_url && oldRevision == d_func()->m_modificationTime) {
+        setModificationRevision(newRevision);
+        return true;
+    }
+    if (!d_func_dynamic()->m_allModificationRevisions.removeModificationRevision(url, oldRevision)) {
+        return false;
+    }
+    d_func_dynamic()->m_allModificationRevisions.addModificationRevision(url, newRevision);
+    return true;
+}
+
 KDevelop::ModificationRevision ParsingEnvironmentFile::modificationRevision() const
 {
     ENSURE_READ_LOCKED
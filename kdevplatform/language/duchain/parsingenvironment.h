@@ -176,6 +176,12 @@ public:
 
     void addModificationRevision(const IndexedString& url, const ModificationRevision& revision);
 
+    ///Replaces the modification-revision @p oldRevision of @p url by @p newRevision, also in the own modification-revision.
+    ///Can be used when a file was touched without changing its contents, so that its importers don't need to be updated.
+    ///@return true if @p oldRevision of @p url was contained
+    bool replaceModificationRevision(const IndexedString& url, const ModificationRevision& oldRevision,
+                                     const ModificationRevision& newRevision);
+
     const ModificationRevisionSet& allModificationRevisions() const;
 
     void addModificationRevisions(const ModificationRevisionSet&);
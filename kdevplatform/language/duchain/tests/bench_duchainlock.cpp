@@ -0,0 +1,146 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "bench_duchainlock.h"
+
+#include <language/duchain/duchain.h>
+#include <language/duchain/duchainlock.h>
+
+#include <tests/testcore.h>
+#include <tests/autotestshell.h>
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QTest>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+QTEST_GUILESS_MAIN(BenchDUChainLock)
+
+using namespace KDevelop;
+
+namespace {
+/**
+ * Repeatedly takes the DUChain lock, every @p writeEvery'th time for writing,
+ * and simulates a bit of work while holding it.
+ */
+class LockWorker
+    : public QThread
+{
+public:
+    LockWorker(int iterations, int writeEvery, const QAtomicInt& stop)
+        : m_iterations(iterations)
+        , m_writeEvery(writeEvery)
+        , m_stop(stop)
+    {
+    }
+
+    void run() override
+    {
+        for (int i = 0; i < m_iterations || (m_iterations < 0 && !m_stop.loadRelaxed()); ++i) {
+            if (m_writeEvery && i % m_writeEvery == 0) {
+                DUChainWriteLocker lock;
+                work();
+            } else {
+                DUChainReadLocker lock;
+                work();
+            }
+        }
+    }
+
+private:
+    void work()
+    {
+        for (int i = 0; i < 100; ++i) {
+            m_sink = m_sink * 31 + i;
+        }
+    }
+
+    const int m_iterations;
+    const int m_writeEvery;
+    const QAtomicInt& m_stop;
+    volatile uint m_sink = 0;
+};
+}
+
+void BenchDUChainLock::initTestCase()
+{
+    AutoTestShell::init();
+    TestCore::initialize(Core::NoUi);
+}
+
+void BenchDUChainLock::cleanupTestCase()
+{
+    TestCore::shutdown();
+}
+
+void BenchDUChainLock::contention_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<int>("writeEvery");
+
+    const int maxThreads = qMax(2, QThread::idealThreadCount());
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        QTest::addRow("read-only-%d", threads) << threads << 0;
+        QTest::addRow("write-1%%-%d", threads) << threads << 100;
+        QTest::addRow("write-10%%-%d", threads) << threads << 10;
+    }
+}
+
+void BenchDUChainLock::contention()
+{
+    QFETCH(int, threads);
+    QFETCH(int, writeEvery);
+
+    const QAtomicInt stop;
+    QBENCHMARK {
+        std::vector<std::unique_ptr<LockWorker>> workers;
+        workers.reserve(threads);
+        for (int i = 0; i < threads; ++i) {
+            workers.push_back(std::make_unique<LockWorker>(10000, writeEvery, stop));
+            workers.back()->start();
+        }
+        for (auto& worker : workers) {
+            QVERIFY(worker->wait());
+        }
+    }
+}
+
+void BenchDUChainLock::writerLatency_data()
+{
+    QTest::addColumn<int>("readers");
+
+    const int maxThreads = qMax(2, QThread::idealThreadCount());
+    for (int readers = 1; readers <= maxThreads; readers *= 2) {
+        QTest::addRow("%d", readers) << readers;
+    }
+}
+
+void BenchDUChainLock::writerLatency()
+{
+    QFETCH(int, readers);
+
+    // measures how long e.g. the foreground thread has to wait for the write lock
+    // while the background parser keeps the chain read-locked all the time
+    QAtomicInt stop;
+    std::vector<std::unique_ptr<LockWorker>> workers;
+    workers.reserve(readers);
+    for (int i = 0; i < readers; ++i) {
+        workers.push_back(std::make_unique<LockWorker>(-1, 0, stop));
+        workers.back()->start();
+    }
+
+    QBENCHMARK {
+        DUChainWriteLocker lock;
+    }
+
+    stop.storeRelaxed(1);
+    for (auto& worker : workers) {
+        QVERIFY(worker->wait());
+    }
+}
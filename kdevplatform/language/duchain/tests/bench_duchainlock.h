@@ -0,0 +1,27 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KDEVPLATFORM_BENCH_DUCHAINLOCK_H
+#define KDEVPLATFORM_BENCH_DUCHAINLOCK_H
+
+#include <QObject>
+
+class BenchDUChainLock
+    : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void contention();
+    void contention_data();
+    void writerLatency();
+    void writerLatency_data();
+};
+
+#endif // KDEVPLATFORM_BENCH_DUCHAINLOCK_H
@@ -0,0 +1,117 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "bench_topducontextdynamicdata.h"
+
+#include <language/duchain/declaration.h>
+#include <language/duchain/duchain.h>
+#include <language/duchain/duchainlock.h>
+#include <language/duchain/ducontext.h>
+#include <language/duchain/topducontext.h>
+#include <language/duchain/topducontextdynamicdata.h>
+#include <serialization/itemrepositoryregistry.h>
+
+#include <tests/testcore.h>
+#include <tests/autotestshell.h>
+
+#include <QFileInfo>
+#include <QTest>
+
+QTEST_GUILESS_MAIN(BenchTopDUContextDynamicData)
+
+using namespace KDevelop;
+
+namespace {
+/// @return the index of a stored and unloaded top-context with @p contextCount contexts of @p declarationCount declarations
+uint createStoredContext(const IndexedString& url, int contextCount, int declarationCount)
+{
+    uint index = 0;
+    {
+        DUChainWriteLocker lock;
+        auto* top = new TopDUContext(url, RangeInRevision(0, 0, contextCount, 0));
+        DUChain::self()->addDocumentChain(top);
+        index = top->ownIndex();
+
+        for (int i = 0; i < contextCount; ++i) {
+            auto* context = new DUContext(RangeInRevision(i, 0, i, 100), top);
+            context->setLocalScopeIdentifier(QualifiedIdentifier(QStringLiteral("Class%1").arg(i)));
+            for (int j = 0; j < declarationCount; ++j) {
+                auto* declaration = new Declaration(RangeInRevision(i, j, i, j + 1), context);
+                declaration->setIdentifier(Identifier(QStringLiteral("member%1").arg(j)));
+            }
+        }
+    }
+    // stores the unreferenced context and unloads it
+    DUChain::self()->storeToDisk();
+    return index;
+}
+}
+
+void BenchTopDUContextDynamicData::initTestCase()
+{
+    AutoTestShell::init();
+    TestCore::initialize(Core::NoUi);
+
+    DUChain::self()->disablePersistentStorage(false);
+}
+
+void BenchTopDUContextDynamicData::cleanupTestCase()
+{
+    TopDUContextDynamicData::setCompressionEnabled(false);
+    TestCore::shutdown();
+}
+
+void BenchTopDUContextDynamicData::load_data()
+{
+    QTest::addColumn<bool>("compressed");
+
+    QTest::newRow("raw") << false;
+    QTest::newRow("compressed") << true;
+}
+
+void BenchTopDUContextDynamicData::load()
+{
+    QFETCH(bool, compressed);
+
+    TopDUContextDynamicData::setCompressionEnabled(compressed);
+
+    const IndexedString url(QStringLiteral("/bench/topcontext-%1.cpp").arg(QLatin1String(QTest::currentDataTag())));
+    const int contextCount = 200;
+    const int declarationCount = 100;
+    const uint index = createStoredContext(url, contextCount, declarationCount);
+    QVERIFY(index);
+
+    {
+        DUChainReadLocker lock;
+        QVERIFY(!DUChain::self()->isInMemory(index));
+    }
+
+    const QFileInfo file(globalItemRepositoryRegistry().path() + QLatin1String("/topcontexts/")
+                         + QString::number(index));
+    QVERIFY(file.exists());
+    qInfo() << "disk footprint of" << QTest::currentDataTag() << "top-context:" << file.size() << "bytes";
+
+    // measures loading the top-context and all its data from the (cached) file
+    int loadedDeclarations = 0;
+    QBENCHMARK_ONCE {
+        DUChainReadLocker lock;
+        auto* top = DUChain::self()->chainForIndex(index);
+        QVERIFY(top);
+        const auto contexts = top->childContexts();
+        for (auto* context : contexts) {
+            const auto declarations = context->localDeclarations();
+            for (auto* declaration : declarations) {
+                loadedDeclarations += !declaration->identifier().isEmpty();
+            }
+        }
+    }
+    QCOMPARE(loadedDeclarations, contextCount * declarationCount);
+
+    DUChainWriteLocker lock;
+    DUChain::self()->removeDocumentChain(DUChain::self()->chainForIndex(index));
+}
+
+#include "moc_bench_topducontextdynamicdata.cpp"
@@ -0,0 +1,25 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KDEVPLATFORM_BENCH_TOPDUCONTEXTDYNAMICDATA_H
+#define KDEVPLATFORM_BENCH_TOPDUCONTEXTDYNAMICDATA_H
+
+#include <QObject>
+
+class BenchTopDUContextDynamicData
+    : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void load();
+    void load_data();
+};
+
+#endif // KDEVPLATFORM_BENCH_TOPDUCONTEXTDYNAMICDATA_H
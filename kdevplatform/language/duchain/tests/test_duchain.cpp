@@ -10,6 +10,7 @@
 
 #include <QTest>
 #include <QElapsedTimer>
+#include <QFile>
 
 #include <tests/autotestshell.h>
 #include <tests/testcore.h>
@@ -27,17 +28,22 @@
 #include <language/duchain/problem.h>
 #include <language/duchain/parsingenvironment.h>
 #include <language/duchain/types/referencetype.h>
+#include <language/duchain/topducontextdynamicdata.h>
 
 #include <language/codegen/coderepresentation.h>
 
 #include <language/util/setrepository.h>
 #include <language/util/basicsetrepository.h>
 
+#include <serialization/itemrepositoryregistry.h>
+
 // #include <typeinfo>
 #include <set>
 #include <algorithm>
 #include <iterator> // needed for std::insert_iterator on windows
 #include <type_traits>
+#include <atomic>
+#include <QSemaphore>
 #include <QThread>
 
 //Extremely slow
@@ -788,6 +794,47 @@ void TestDUChain::testLockForReadWrite()
     threads.join();
 }
 
+void TestDUChain::testLockTimeout()
+{
+    QSemaphore locked;
+    QSemaphore release;
+    QScopedPointer<QThread> writer(QThread::create([&]() {
+        DUChainWriteLocker lock;
+        locked.release();
+        release.acquire();
+    }));
+    writer->start();
+    locked.acquire();
+
+    {
+        DUChainReadLocker lock(nullptr, 10);
+        QVERIFY(!lock.locked());
+    }
+    {
+        DUChainWriteLocker lock(nullptr, 10);
+        QVERIFY(!lock.locked());
+    }
+
+    // a reader blocked in another thread must get woken up once the writer is gone
+    QSemaphore readerStarted;
+    std::atomic<bool> readerLocked{false};
+    QScopedPointer<QThread> reader(QThread::create([&]() {
+        readerStarted.release();
+        DUChainReadLocker lock(nullptr, 10000);
+        readerLocked = lock.locked();
+    }));
+    reader->start();
+    readerStarted.acquire();
+    // give the reader the time to block on the lock
+    QThread::msleep(100);
+    QVERIFY(!reader->isFinished());
+
+    release.release();
+    QVERIFY(writer->wait(3000));
+    QVERIFY(reader->wait(3000));
+    QVERIFY(readerLocked);
+}
+
 void TestDUChain::testProblemSerialization()
 {
     DUChain::self()->disablePersistentStorage(false);
@@ -865,6 +912,72 @@ void TestDUChain::testProblemSerialization()
     QVERIFY(parent->diagnostics().isEmpty());
 }
 
+void TestDUChain::testCorruptedCompressedTopContext_data()
+{
+    QTest::addColumn<int>("truncatedBytes");
+    QTest::addColumn<bool>("garbled");
+
+    QTest::newRow("truncated") << 4 << false;
+    QTest::newRow("garbled") << 0 << true;
+}
+
+void TestDUChain::testCorruptedCompressedTopContext()
+{
+    QFETCH(int, truncatedBytes);
+    QFETCH(bool, garbled);
+
+    DUChain::self()->disablePersistentStorage(false);
+    TopDUContextDynamicData::setCompressionEnabled(true);
+
+    const IndexedString url(QStringLiteral("/my/test/compressed-%1").arg(QLatin1String(QTest::currentDataTag())));
+    uint index = 0;
+    {
+        DUChainWriteLocker lock;
+        auto top = new TopDUContext(url, RangeInRevision(0, 0, 10, 0));
+        DUChain::self()->addDocumentChain(top);
+        index = top->ownIndex();
+        for (int i = 0; i < 10; ++i) {
+            auto* context = new DUContext(RangeInRevision(i, 0, i, 100), top);
+            context->setLocalScopeIdentifier(QualifiedIdentifier(QStringLiteral("Class%1").arg(i)));
+        }
+    }
+    DUChain::self()->storeToDisk();
+    TopDUContextDynamicData::setCompressionEnabled(false);
+
+    {
+        QFile file(globalItemRepositoryRegistry().path() + QLatin1String("/topcontexts/") + QString::number(index));
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        if (truncatedBytes) {
+            QVERIFY(file.resize(file.size() - truncatedBytes));
+        }
+        if (garbled) {
+            // the header of the first compressed block, which is validated without decompressing the block
+            const auto readUint = [&file]() {
+                uint value = 0;
+                file.read(reinterpret_cast<char*>(&value), sizeof(uint));
+                return value;
+            };
+            QVERIFY(file.seek(sizeof(uint) + (readUint() & ~(1u << 31))));
+            for (int storage = 0; storage < 3; ++storage) {
+                QVERIFY(file.seek(file.pos() + sizeof(TopDUContextDynamicData::ItemDataInfo) * readUint()));
+            }
+            readUint(); // the uncompressed size
+            const uint blockCount = readUint();
+            QVERIFY(file.seek(file.pos() + sizeof(uint) * blockCount));
+            file.write(QByteArray(4, '\xff'));
+        }
+    }
+
+    {
+        DUChainReadLocker lock;
+        QVERIFY(!DUChain::self()->isInMemory(index));
+        // the corrupted file is discarded, so that the document is parsed again
+        QVERIFY(!DUChain::self()->chainForIndex(index));
+    }
+
+    DUChain::self()->disablePersistentStorage(true);
+}
+
 void TestDUChain::testIdentifiers()
 {
     QualifiedIdentifier aj(QStringLiteral("::Area::jump"));
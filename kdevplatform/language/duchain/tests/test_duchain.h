@@ -31,7 +31,10 @@ private Q_SLOTS:
     void testLockForWrite();
     void testLockForRead();
     void testLockForReadWrite();
+    void testLockTimeout();
     void testProblemSerialization();
+    void testCorruptedCompressedTopContext_data();
+    void testCorruptedCompressedTopContext();
     void testIdentifiers();
     void testTypePtr();
     void testReferenceType();
@@ -10,6 +10,12 @@
 #include <typeinfo>
 #include <QFile>
 #include <QByteArray>
+#include <QtEndian>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
 
 #include "declaration.h"
 #include "declarationdata.h"
@@ -144,6 +150,148 @@ void verifyDataInfo(const TopDUContextDynamicData::ItemDataInfo& info,
 #endif
 }
 
+/// Set in the top-context data size at the start of a file, when the item data is stored block-compressed.
+constexpr uint compressedDataFlag = 1u << 31;
+/// Uncompressed size of the blocks of compressed item data.
+constexpr int compressedBlockSize = 64 * 1024;
+
+std::atomic<bool> compressData{qEnvironmentVariableIsSet("KDEV_DUCHAIN_COMPRESSION")};
+
+/// Reads the size of the top-context data at the start of @p file.
+uint readTopContextDataSize(QFile* file, bool* compressed = nullptr)
+{
+    uint readValue = 0;
+    file->read(reinterpret_cast<char*>(&readValue), sizeof(uint));
+    if (compressed) {
+        *compressed = readValue & compressedDataFlag;
+    }
+    return readValue & ~compressedDataFlag;
+}
+
+/**
+ * Writes @p data as a sequence of independently compressed blocks.
+ *
+ * Layout: the uncompressed size, the block count, the compressed size of every block, the blocks.
+ */
+void writeCompressedData(QFile* file, const QVector<TopDUContextDynamicData::ArrayWithPosition>& data)
+{
+    QByteArray rawData;
+    for (const auto& pos : data) {
+        rawData.append(pos.array.constData(), pos.position);
+    }
+
+    QVector<QByteArray> blocks;
+    blocks.reserve(rawData.size() / compressedBlockSize + 1);
+    for (int offset = 0; offset < rawData.size(); offset += compressedBlockSize) {
+        const int size = std::min(compressedBlockSize, static_cast<int>(rawData.size()) - offset);
+        // a low compression level, the data is written far more often than it is read back
+        blocks.append(qCompress(reinterpret_cast<const uchar*>(rawData.constData()) + offset, size, 1));
+    }
+
+    const uint dataSize = rawData.size();
+    file->write(reinterpret_cast<const char*>(&dataSize), sizeof(uint));
+    const uint blockCount = blocks.size();
+    file->write(reinterpret_cast<const char*>(&blockCount), sizeof(uint));
+    for (const auto& block : std::as_const(blocks)) {
+        const uint blockSize = block.size();
+        file->write(reinterpret_cast<const char*>(&blockSize), sizeof(uint));
+    }
+    for (const auto& block : std::as_const(blocks)) {
+        file->write(block);
+    }
+}
+
+/// The sizes stored at the start of data written by writeCompressedData().
+struct CompressedDataIndex
+{
+    uint dataSize = 0;
+    QVector<uint> blockSizes;
+};
+
+bool corruptedCompressedData(const QFile* file)
+{
+    qCWarning(LANGUAGE) << "Corrupted compressed top-context data in" << file->fileName();
+    return false;
+}
+
+/**
+ * Reads the sizes at the start of data written by writeCompressedData() into @p index,
+ * and leaves @p file positioned at the first block.
+ *
+ * @return false if the data is corrupted, all sizes are checked against the size of @p file before
+ *         anything is allocated, and the header of every block must announce the size it was written with.
+ *         The blocks themselves are not decompressed, see readCompressedData().
+ */
+bool readCompressedDataIndex(QFile* file, CompressedDataIndex& index)
+{
+    uint blockCount = 0;
+    if (file->read(reinterpret_cast<char*>(&index.dataSize), sizeof(uint)) != sizeof(uint)
+        || file->read(reinterpret_cast<char*>(&blockCount), sizeof(uint)) != sizeof(uint)) {
+        return corruptedCompressedData(file);
+    }
+    if (index.dataSize > static_cast<uint>(std::numeric_limits<int>::max())
+        || blockCount != (static_cast<qint64>(index.dataSize) + compressedBlockSize - 1) / compressedBlockSize) {
+        return corruptedCompressedData(file);
+    }
+    const qint64 blockSizesSize = static_cast<qint64>(sizeof(uint)) * blockCount;
+    if (blockSizesSize > file->size() - file->pos()) {
+        return corruptedCompressedData(file);
+    }
+    index.blockSizes.resize(blockCount);
+    if (file->read(reinterpret_cast<char*>(index.blockSizes.data()), blockSizesSize) != blockSizesSize) {
+        return corruptedCompressedData(file);
+    }
+    // the blocks are the rest of the file
+    qint64 blocksSize = 0;
+    for (uint blockSize : std::as_const(index.blockSizes)) {
+        blocksSize += blockSize;
+    }
+    if (blocksSize != file->size() - file->pos()) {
+        return corruptedCompressedData(file);
+    }
+
+    // qCompress() puts the uncompressed size in front of every block, as a big-endian 32-bit value
+    const qint64 blocksPos = file->pos();
+    qint64 blockPos = blocksPos;
+    qint64 remainingSize = index.dataSize;
+    for (uint blockSize : std::as_const(index.blockSizes)) {
+        quint32 header = 0;
+        if (blockSize < sizeof(header) || !file->seek(blockPos)
+            || file->read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)
+            || qFromBigEndian(header) != std::min<qint64>(compressedBlockSize, remainingSize)) {
+            return corruptedCompressedData(file);
+        }
+        blockPos += blockSize;
+        remainingSize -= compressedBlockSize;
+    }
+    file->seek(blocksPos);
+    return true;
+}
+
+/**
+ * Decompresses the blocks of data written by writeCompressedData(), @p file must be positioned
+ * at the first block, as left by readCompressedDataIndex().
+ *
+ * A block that fails to decompress, although its header was valid, is left zeroed.
+ */
+QByteArray readCompressedData(QFile* file, const CompressedDataIndex& index)
+{
+    QByteArray data(index.dataSize, 0);
+    char* target = data.data();
+    for (uint blockSize : std::as_const(index.blockSizes)) {
+        const QByteArray block = qUncompress(file->read(blockSize));
+        const qint64 expectedSize = std::min<qint64>(compressedBlockSize, data.constData() + data.size() - target);
+        if (block.size() == expectedSize) {
+            std::memcpy(target, block.constData(), block.size());
+        } else {
+            corruptedCompressedData(file);
+        }
+        target += expectedSize;
+    }
+    Q_ASSERT(target == data.constData() + data.size());
+    return data;
+}
+
 QString basePath()
 {
     return globalItemRepositoryRegistry().path() + QLatin1String("/topcontexts/");
@@ -166,9 +314,7 @@ void loadTopDUContextData(const uint topContextIndex, LoadType loadType, F callb
         return;
     }
 
-    uint readValue;
-    file.read(reinterpret_cast<char*>(&readValue), sizeof(uint));
-    // now readValue is filled with the top-context data size
+    const uint readValue = readTopContextDataSize(&file);
     Q_ASSERT(readValue >= sizeof(TopDUContextData));
     const QByteArray data = file.read(loadType == FullLoad ? readValue : sizeof(TopDUContextData));
     const auto* topData = reinterpret_cast<const TopDUContextData*>(data.constData());
@@ -492,6 +638,16 @@ void KDevelop::TopDUContextDynamicData::unmap()
     m_mappedDataSize = 0;
 }
 
+bool TopDUContextDynamicData::compressionEnabled()
+{
+    return compressData.load(std::memory_order_relaxed);
+}
+
+void TopDUContextDynamicData::setCompressionEnabled(bool enabled)
+{
+    compressData.store(enabled, std::memory_order_relaxed);
+}
+
 bool TopDUContextDynamicData::fileExists(uint topContextIndex)
 {
     return QFile::exists(pathForTopContext(topContextIndex));
@@ -548,14 +704,24 @@ void TopDUContextDynamicData::loadData() const
 
     //Skip the offsets, we're already read them
     //Skip top-context data
-    uint readValue;
-    file->read(reinterpret_cast<char*>(&readValue), sizeof(uint));
+    bool compressed = false;
+    const uint readValue = readTopContextDataSize(file, &compressed);
     file->seek(readValue + file->pos());
 
     m_contexts.loadData(file);
     m_declarations.loadData(file);
     m_problems.loadData(file);
 
+    if (compressed) {
+        // the sizes and block headers were validated by load() already
+        CompressedDataIndex index;
+        const QByteArray data = readCompressedDataIndex(file, index) ? readCompressedData(file, index) : QByteArray();
+        m_data.append({data, static_cast<uint>(data.size())});
+        delete file;
+        m_dataLoaded = true;
+        return;
+    }
+
 #ifdef USE_MMAP
 
     m_mappedData = file->map(file->pos(), file->size() - file->pos());
@@ -587,11 +753,33 @@ TopDUContext* TopDUContextDynamicData::load(uint topContextIndex)
             return nullptr;
         }
 
-        uint readValue;
-        file.read(reinterpret_cast<char*>(&readValue), sizeof(uint));
-        //now readValue is filled with the top-context data size
+        bool compressed = false;
+        const uint readValue = readTopContextDataSize(&file, &compressed);
+        if (readValue < sizeof(TopDUContextData) || readValue > file.size() - file.pos()) {
+            qCWarning(LANGUAGE) << "Corrupted top-context file" << file.fileName();
+            return nullptr;
+        }
         QByteArray topContextData = file.read(readValue);
 
+        // Only the sizes and block headers of compressed item data are validated here, the blocks are
+        // decompressed on demand by loadData(). A file with corrupted sizes is discarded, and its document
+        // parsed again, instead of failing later when the items are loaded.
+        if (compressed) {
+            for (int storage = 0; storage < 3; ++storage) {
+                uint itemCount = 0;
+                if (file.read(reinterpret_cast<char*>(&itemCount), sizeof(uint)) != sizeof(uint)
+                    || static_cast<qint64>(sizeof(ItemDataInfo)) * itemCount > file.size() - file.pos()) {
+                    qCWarning(LANGUAGE) << "Corrupted top-context file" << file.fileName();
+                    return nullptr;
+                }
+                file.seek(file.pos() + sizeof(ItemDataInfo) * itemCount);
+            }
+            CompressedDataIndex index;
+            if (!readCompressedDataIndex(&file, index)) {
+                return nullptr;
+            }
+        }
+
         auto* topData = reinterpret_cast<DUChainBaseData*>(topContextData.data());
         auto* ret = dynamic_cast<TopDUContext*>(DUChainItemSystem::self().create(topData));
         if (!ret) {
@@ -726,7 +914,10 @@ void TopDUContextDynamicData::store()
     if (file.open(QIODevice::WriteOnly)) {
         file.resize(0);
 
-        file.write(reinterpret_cast<const char*>(&topContextDataSize), sizeof(uint));
+        const bool compressed = compressionEnabled();
+        Q_ASSERT(!(topContextDataSize & compressedDataFlag));
+        const uint sizeAndFlags = topContextDataSize | (compressed ? compressedDataFlag : 0);
+        file.write(reinterpret_cast<const char*>(&sizeAndFlags), sizeof(uint));
         for (const ArrayWithPosition& pos : std::as_const(m_topContextData)) {
             file.write(pos.array.constData(), pos.position);
         }
@@ -735,8 +926,12 @@ void TopDUContextDynamicData::store()
         m_declarations.writeData(&file);
         m_problems.writeData(&file);
 
-        for (const ArrayWithPosition& pos : std::as_const(m_data)) {
-            file.write(pos.array.constData(), pos.position);
+        if (compressed) {
+            writeCompressedData(&file, m_data);
+        } else {
+            for (const ArrayWithPosition& pos : std::as_const(m_data)) {
+                file.write(pos.array.constData(), pos.position);
+            }
         }
 
         m_onDisk = true;
@@ -9,6 +9,7 @@
 
 #include <QVector>
 #include <QByteArray>
+#include <language/languageexport.h>
 #include "problem.h"
 
 class QFile;
@@ -84,6 +85,17 @@ public:
 
     static bool fileExists(uint topContextIndex);
 
+    /**
+     * Whether store() compresses the data of the contexts, declarations and problems in independent blocks.
+     * This reduces the disk footprint a lot, but the data can't be mapped into memory on load anymore.
+     * The header, which contains e.g. the url and the imports, stays uncompressed.
+     *
+     * Disabled by default, can be enabled by setting the KDEV_DUCHAIN_COMPRESSION environment variable.
+     * Both formats can be loaded regardless of this setting.
+     */
+    KDEVPLATFORMLANGUAGE_EXPORT static bool compressionEnabled();
+    KDEVPLATFORMLANGUAGE_EXPORT static void setCompressionEnabled(bool enabled);
+
     ///Loads only the list of importers out of the data stored on disk for the top-context.
     static QList<IndexedDUContext> loadImporters(uint topContextIndex);
 
@@ -103,14 +103,14 @@ public:
 };
 
 // Maps declaration-ids to Uses
-using UsesRepo = ItemRepository<UsesItem, UsesRequestItem>;
+using UsesRepo = ItemRepository<UsesItem, UsesRequestItem, true, std::shared_mutex>;
 template<>
 class ItemRepositoryFor<Uses>
 {
     friend struct LockedItemRepository;
     static UsesRepo& repo()
     {
-        static QMutex mutex;
+        static std::shared_mutex mutex;
         static UsesRepo repo { QStringLiteral("Use Map"), &mutex };
         return repo;
     }
@@ -286,6 +286,22 @@ QString ModificationRevisionSet::toString() const
     return ret;
 }
 
+QVector<std::pair<IndexedString, ModificationRevision>> ModificationRevisionSet::outdatedRevisions() const
+{
+    QMutexLocker lock(modificationRevisionSetMutex());
+    Utils::Set set(m_index, &FileModificationSetRepositoryRepresenter::repository());
+    Utils::Set::Iterator it = set.iterator();
+    QVector<std::pair<IndexedString, ModificationRevision>> ret;
+    while (it) {
+        const FileModificationPair* data = fileModificationPairRepository().itemFromIndex(*it);
+        if (KDevelop::ModificationRevision::revisionForFile(data->file) != data->revision) {
+            ret.append({data->file, data->revision});
+        }
+        ++it;
+    }
+    return ret;
+}
+
 bool ModificationRevisionSet::needsUpdate() const
 {
     QMutexLocker lock(modificationRevisionSetMutex());
@@ -9,6 +9,10 @@
 
 #include "modificationrevision.h"
 
+#include <QVector>
+
+#include <utility>
+
 namespace KDevelop {
 /**
  * This class represents a set of modification-revisions assigned to file-names.
@@ -39,6 +43,9 @@ public:
 
     bool needsUpdate() const;
 
+    ///Returns the files whose current modification-revision differs from the one in this set, together with the stored revision
+    QVector<std::pair<IndexedString, ModificationRevision>> outdatedRevisions() const;
+
     QString toString() const;
 
     bool operator!=(const ModificationRevisionSet& rhs) const
@@ -12,8 +12,10 @@
 #include <KLocalizedString>
 
 #include <QFileInfo>
+#include <QHash>
 
 #include <algorithm>
+#include <iterator>
 
 namespace KDevelop
 {
@@ -78,6 +80,10 @@ public:
 
     using PositionMap = QHash<Path, int>;
     PositionMap m_positionInCurrentDirs;
+
+    /// Relative file names found in m_currentDirs, valid until m_currentDirs changes.
+    /// Compilers report many errors for the same files, which then need not be looked up again.
+    mutable QHash<QString, Path> m_resolvedPaths;
 };
 
 CompilerFilterStrategyPrivate::CompilerFilterStrategyPrivate(const QUrl& buildDir)
@@ -94,11 +100,22 @@ Path CompilerFilterStrategyPrivate::pathForFile(const QString& filename) const
             return Path(m_buildDir, filename );
         }
 
+        const auto resolvedIt = m_resolvedPaths.constFind(filename);
+        if (resolvedIt != m_resolvedPaths.constEnd()) {
+            return *resolvedIt;
+        }
+
+        bool exists = false;
         auto it = m_currentDirs.constEnd() - 1;
         do {
             currentPath = Path(*it, filename);
-        } while( (it-- !=  m_currentDirs.constBegin()) && !QFileInfo::exists(currentPath.toLocalFile()) );
+            exists = QFileInfo::exists(currentPath.toLocalFile());
+        } while (!exists && it-- != m_currentDirs.constBegin());
 
+        // files not found (yet) are looked up again next time
+        if (exists) {
+            m_resolvedPaths.insert(filename, currentPath);
+        }
         return currentPath;
     } else {
         currentPath = Path(filename);
@@ -121,11 +138,13 @@ void CompilerFilterStrategyPrivate::putDirAtEnd(const Path& pathToInsert)
     if (it == m_positionInCurrentDirs.end()) {
         m_currentDirs.push_back( pathToInsert );
         m_positionInCurrentDirs.insert( pathToInsert, m_currentDirs.size() - 1 );
-    } else {
+        m_resolvedPaths.clear();
+    } else if (it.value() != m_currentDirs.size() - 1) {
         // Build dir already in currentDirs, but move it to back of currentDirs list
         // (this gives us most-recently-used semantics in pathForFile)
         std::rotate(m_currentDirs.begin() + it.value(), m_currentDirs.begin() + it.value() + 1, m_currentDirs.end() );
         it.value() = m_currentDirs.size() - 1;
+        m_resolvedPaths.clear();
     }
 }
 
@@ -195,8 +214,16 @@ FilteredItem CompilerFilterStrategy::actionInLine(const QString& line)
                       QStringLiteral("(Waf|scons): Entering directory (\\`|\\')(.+)'"), 3)
     };
 
+    static const FormatPrefilter ACTION_PREFILTER(ACTION_FILTERS);
+
     FilteredItem item(line);
-    for (const auto& curActFilter : ACTION_FILTERS) {
+    // most lines are neither actions nor errors, only try the filters whose literal text is in the line
+    const auto candidates = ACTION_PREFILTER.candidates(line);
+    for (int i = 0; i < static_cast<int>(std::size(ACTION_FILTERS)); ++i) {
+        if (!FormatPrefilter::isCandidate(candidates, i)) {
+            continue;
+        }
+        const auto& curActFilter = ACTION_FILTERS[i];
         const auto match = curActFilter.expression.match(line);
         if( match.hasMatch() ) {
             item.type = FilteredItem::ActionItem;
@@ -205,6 +232,7 @@ FilteredItem CompilerFilterStrategy::actionInLine(const QString& line)
                 const Path path(match.captured(curActFilter.fileGroup));
                 d->m_currentDirs.push_back( path );
                 d->m_positionInCurrentDirs.insert( path , d->m_currentDirs.size() - 1 );
+                d->m_resolvedPaths.clear();
             }
 
             // Special case for cmake: we parse the "Compiling <objectfile>" expression
@@ -297,8 +325,15 @@ FilteredItem CompilerFilterStrategy::errorInLine(const QString& line)
                     QStringLiteral("tsc"), 3),
     };
 
+    static const FormatPrefilter ERROR_PREFILTER(ERROR_FILTERS);
+
     FilteredItem item(line);
-    for (const auto& curErrFilter : ERROR_FILTERS) {
+    const auto candidates = ERROR_PREFILTER.candidates(line);
+    for (int i = 0; i < static_cast<int>(std::size(ERROR_FILTERS)); ++i) {
+        if (!FormatPrefilter::isCandidate(candidates, i)) {
+            continue;
+        }
+        const auto& curErrFilter = ERROR_FILTERS[i];
         const auto match = curErrFilter.expression.match(line);
         if( match.hasMatch() && !( line.contains( QLatin1String("Each undeclared identifier is reported only once") )
                                || line.contains( QLatin1String("for each function it appears in.") ) ) )
@@ -10,15 +10,155 @@
 
 #include <KLocalizedString>
 
+#include <QQueue>
+
 namespace KDevelop
 {
 
+QString requiredLiteral(const QRegularExpression& expression)
+{
+    const QString pattern = expression.pattern();
+    if (expression.patternOptions()
+        & (QRegularExpression::CaseInsensitiveOption | QRegularExpression::ExtendedPatternSyntaxOption)) {
+        return QString();
+    }
+
+    // Only the texts outside of groups and character classes are considered, a quantifier makes the
+    // character before it optional and an alternation at the top level makes everything optional.
+    QString longest;
+    QString current;
+    const auto endCurrent = [&]() {
+        if (current.size() > longest.size()) {
+            longest = current;
+        }
+        current.clear();
+    };
+    bool lastWasLiteral = false;
+    int depth = 0;
+    for (int i = 0; i < pattern.size(); ++i) {
+        const QChar c = pattern[i];
+        if (c == QLatin1Char('[')) {
+            // skip the character class, a ']' right after the opening bracket is part of it
+            int end = i + 1;
+            if (end < pattern.size() && pattern[end] == QLatin1Char('^')) {
+                ++end;
+            }
+            if (end < pattern.size() && pattern[end] == QLatin1Char(']')) {
+                ++end;
+            }
+            while (end < pattern.size() && pattern[end] != QLatin1Char(']')) {
+                if (pattern[end] == QLatin1Char('\\')) {
+                    ++end;
+                } else if (pattern[end] == QLatin1Char('[') && end + 1 < pattern.size()
+                           && QStringView(u":.=").contains(pattern[end + 1])) {
+                    // POSIX classes such as [:alpha:] end with a ']' of their own
+                    const QChar kind = pattern[end + 1];
+                    end += 2;
+                    while (end + 1 < pattern.size()
+                           && !(pattern[end] == kind && pattern[end + 1] == QLatin1Char(']'))) {
+                        ++end;
+                    }
+                    ++end;
+                }
+                ++end;
+            }
+            i = end;
+            endCurrent();
+            lastWasLiteral = false;
+            continue;
+        }
+        if (c == QLatin1Char('\\')) {
+            ++i;
+            if (i == pattern.size()) {
+                return QString();
+            }
+            const QChar escaped = pattern[i];
+            if (escaped.unicode() >= 0x80) {
+                return QString();
+            }
+            if (!escaped.isLetterOrNumber()) {
+                if (depth == 0) {
+                    current += escaped;
+                    lastWasLiteral = true;
+                }
+                continue;
+            }
+            // character classes and assertions, anything else (e.g. back references, character codes
+            // or quoting) is not worth understanding here
+            if (!QStringView(u"bBdDsSwWntr").contains(escaped)) {
+                return QString();
+            }
+            if (depth == 0) {
+                endCurrent();
+                lastWasLiteral = false;
+            }
+            continue;
+        }
+        if (c == QLatin1Char('(')) {
+            // inline options would change the meaning of the text after them
+            if (i + 2 < pattern.size() && pattern[i + 1] == QLatin1Char('?')
+                && !QStringView(u":=!<").contains(pattern[i + 2])) {
+                return QString();
+            }
+            if (depth++ == 0) {
+                endCurrent();
+                lastWasLiteral = false;
+            }
+            continue;
+        }
+        if (c == QLatin1Char(')')) {
+            --depth;
+            continue;
+        }
+        if (depth > 0) {
+            continue;
+        }
+
+        switch (c.unicode()) {
+        case '|':
+            return QString();
+        case '?':
+        case '*':
+        case '{':
+            if (lastWasLiteral) {
+                current.chop(1);
+            }
+            endCurrent();
+            lastWasLiteral = false;
+            if (c == QLatin1Char('{')) {
+                while (i < pattern.size() && pattern[i] != QLatin1Char('}')) {
+                    ++i;
+                }
+            }
+            break;
+        case '+':
+        case '.':
+        case '^':
+        case '$':
+            endCurrent();
+            lastWasLiteral = false;
+            break;
+        default:
+            if (c.unicode() < 0x80) {
+                current += c;
+                lastWasLiteral = true;
+            } else {
+                endCurrent();
+                lastWasLiteral = false;
+            }
+        }
+    }
+    endCurrent();
+    return longest;
+}
+
 ErrorFormat::ErrorFormat( const QString& regExp, int file, int line, int text, int column )
     : expression( regExp )
     , fileGroup( file )
     , lineGroup( line )
     , columnGroup( column )
     , textGroup( text )
+    , literal( requiredLiteral(expression) )
 {}
 
 ErrorFormat::ErrorFormat( const QString& regExp, int file, int line, int text, const QString& comp, int column )
@@ -28,18 +168,21 @@ ErrorFormat::ErrorFormat( const QString& regExp, int file, int line, int text, c
     , columnGroup( column )
     , textGroup( text )
     , compiler( comp )
+    , literal( requiredLiteral(expression) )
 {}
 
 ActionFormat::ActionFormat(const QString& _tool, const QString& regExp, int file )
     : expression( regExp )
     , tool( _tool )
     , fileGroup( file )
+    , literal( requiredLiteral(expression) )
 {
 }
 
 ActionFormat::ActionFormat(int file, const QString& regExp)
     : expression( regExp )
     , fileGroup( file )
+    , literal( requiredLiteral(expression) )
 {
 }
 
@@ -48,5 +191,68 @@ int ErrorFormat::columnNumber(const QRegularExpressionMatch& match) const
     return columnGroup < 0 ? 0 : std::max(match.capturedView(columnGroup).toInt() - 1, 0);
 }
 
+void FormatPrefilter::build(const QVector<QString>& literals)
+{
+    Q_ASSERT(literals.size() <= 64);
+
+    // the trie of the literals
+    m_transitions.append({});
+    m_matches.append(0);
+    for (int format = 0; format < literals.size(); ++format) {
+        const QString& literal = literals[format];
+        if (literal.isEmpty()) {
+            m_alwaysCandidates |= Candidates{1} << format;
+            continue;
+        }
+        int state = 0;
+        for (const QChar c : literal) {
+            Q_ASSERT(c.unicode() < 0x80);
+            auto next = m_transitions[state][c.unicode()];
+            if (next == 0) {
+                next = m_transitions.size();
+                m_transitions[state][c.unicode()] = next;
+                m_transitions.append({});
+                m_matches.append(0);
+            }
+            state = next;
+        }
+        m_matches[state] |= Candidates{1} << format;
+    }
+
+    // turn the trie into the automaton, following the failure links breadth first
+    QVector<quint16> failure(m_transitions.size(), 0);
+    QQueue<quint16> queue;
+    for (const auto next : std::as_const(m_transitions[0])) {
+        if (next != 0) {
+            queue.enqueue(next);
+        }
+    }
+    while (!queue.isEmpty()) {
+        const quint16 state = queue.dequeue();
+        m_matches[state] |= m_matches[failure[state]];
+        for (int c = 0; c < 128; ++c) {
+            const quint16 next = m_transitions[state][c];
+            if (next != 0) {
+                failure[next] = m_transitions[failure[state]][c];
+                queue.enqueue(next);
+            } else {
+                m_transitions[state][c] = m_transitions[failure[state]][c];
+            }
+        }
+    }
+}
+
+FormatPrefilter::Candidates FormatPrefilter::candidates(QStringView line) const
+{
+    Candidates candidates = m_alwaysCandidates;
+    quint16 state = 0;
+    for (const QChar c : line) {
+        // the literals are ASCII, so any other character ends all partial matches
+        state = c.unicode() < 0x80 ? m_transitions[state][c.unicode()] : 0;
+        candidates |= m_matches[state];
+    }
+    return candidates;
+}
+
 }
 
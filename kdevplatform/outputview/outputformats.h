@@ -9,12 +9,23 @@
 #ifndef KDEVPLATFORM_OUTPUTFORMATS_H
 #define KDEVPLATFORM_OUTPUTFORMATS_H
 
+#include "outputviewexport.h"
+
 #include <QString>
 #include <QRegularExpression>
+#include <QVector>
+
+#include <array>
 
 namespace KDevelop
 {
 
+/**
+ * @return the longest text which every match of @p expression contains verbatim,
+ *         or an empty string if no such text can be found in its pattern
+ */
+KDEVPLATFORMOUTPUTVIEW_EXPORT QString requiredLiteral(const QRegularExpression& expression);
+
 struct ActionFormat
 {
     ActionFormat() = default;
@@ -23,6 +34,8 @@ struct ActionFormat
     QRegularExpression expression;
     QString tool;
     int fileGroup;
+    /// Text contained in every line the expression matches, see requiredLiteral()
+    QString literal;
 };
 
 struct ErrorFormat
@@ -35,6 +48,8 @@ struct ErrorFormat
     int lineGroup, columnGroup;
     int textGroup;
     QString compiler;
+    /// Text contained in every line the expression matches, see requiredLiteral()
+    QString literal;
 
     // Returns the column number starting with 0 as the first column
     // If no match was found for columns or if index was not valid
@@ -42,6 +57,47 @@ struct ErrorFormat
     int columnNumber(const QRegularExpressionMatch& match) const;
 };
 
+/**
+ * Finds the formats of a list that may match a line, by looking for their required literals
+ * in a single pass over the line, so that only those formats need to try their expressions.
+ *
+ * This is an Aho-Corasick automaton over the ASCII literals of at most 64 formats.
+ */
+class KDEVPLATFORMOUTPUTVIEW_EXPORT FormatPrefilter
+{
+public:
+    using Candidates = quint64;
+
+    template<typename Formats>
+    explicit FormatPrefilter(const Formats& formats)
+    {
+        QVector<QString> literals;
+        for (const auto& format : formats) {
+            literals.append(format.literal);
+        }
+        build(literals);
+    }
+
+    /// @return the bit mask of the formats that may match @p line, the bit of a format is set
+    ///         if its literal occurs in @p line or if it has none
+    Candidates candidates(QStringView line) const;
+
+    static bool isCandidate(Candidates candidates, int formatIndex)
+    {
+        return candidates & (Candidates{1} << formatIndex);
+    }
+
+private:
+    void build(const QVector<QString>& literals);
+
+    /// transitions of the automaton, indexed by state and ASCII character
+    QVector<std::array<quint16, 128>> m_transitions;
+    /// the formats whose literal ends in a state
+    QVector<Candidates> m_matches;
+    /// the formats without a literal
+    Candidates m_alwaysCandidates = 0;
+};
+
 }
 #endif
 
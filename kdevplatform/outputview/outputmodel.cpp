@@ -15,92 +15,317 @@
 #include <interfaces/idocumentcontroller.h>
 #include <util/kdevstringhandler.h>
 
+#include <QElapsedTimer>
+#include <QMutex>
 #include <QStringList>
+#include <QTemporaryFile>
+#include <QThreadPool>
 #include <QTimer>
-#include <QThread>
 #include <QFont>
 #include <QFontDatabase>
 
+#include <deque>
 #include <functional>
+#include <map>
+#include <memory>
+#include <optional>
 #include <set>
 
 namespace KDevelop
 {
 
 /**
- * Number of lines that are processed in one go before we notify the GUI thread
- * about the result. It is generally faster to add multiple items to a model
- * in one go compared to adding each item independently.
+ * Bounds of the number of lines that a parse worker processes in one go before it passes
+ * the result on. The batch size follows the rate of incoming lines: the more lines are
+ * waiting, the larger the batches.
  */
-static const int BATCH_SIZE = 50;
+static const int MIN_BATCH_SIZE = 50;
+static const int MAX_BATCH_SIZE = 8192;
 
 /**
- * Time in ms that we wait in the parse worker for new incoming lines before
- * actually processing them. If we already have enough for one batch though
- * we process immediately.
+ * Time in ms between two insertions of parsed lines into the model. It is generally faster
+ * to add multiple items to a model in one go compared to adding each item independently,
+ * and the view does not need to be updated more often than it can be painted.
  */
-static const int BATCH_AGGREGATE_TIME_DELAY = 50;
+static const int INSERTION_INTERVAL = 40;
 
-class ParseWorker : public QObject
+/**
+ * Number of lines whose text is kept in memory by default, the text of older lines
+ * is moved to a temporary file.
+ */
+static const int DEFAULT_MAX_LINES_IN_MEMORY = 100000;
+
+/**
+ * Number of lines that are stored together and moved to the temporary file in one go.
+ */
+static const int LINES_PER_CHUNK = 4096;
+
+/**
+ * Compact storage of the text and type of the output lines.
+ *
+ * The lines are kept as UTF-8 in chunks of LINES_PER_CHUNK lines. When more than the
+ * configured count of lines is in memory, the oldest complete chunks are written to a
+ * temporary file and read from there through a memory mapping.
+ */
+class OutputLineStorage
 {
-    Q_OBJECT
 public:
-    ParseWorker()
-        : QObject(nullptr)
-        , m_filter(new NoFilterStrategy)
-        , m_timer(new QTimer(this))
+    int size() const
+    {
+        return m_size;
+    }
+
+    void append(const QString& line, FilteredItem::FilteredOutputItemType type)
+    {
+        if (m_chunks.empty() || m_chunks.back().types.size() == LINES_PER_CHUNK) {
+            m_chunks.emplace_back();
+            auto& chunk = m_chunks.back();
+            chunk.lineStarts.reserve(LINES_PER_CHUNK + 1);
+            chunk.lineStarts.append(0);
+            chunk.types.reserve(LINES_PER_CHUNK);
+        }
+        auto& chunk = m_chunks.back();
+        chunk.text += line.toUtf8();
+        chunk.lineStarts.append(chunk.text.size());
+        chunk.types.append(static_cast<char>(type));
+        ++m_size;
+        ++m_linesInMemory;
+
+        // the last chunk is still growing, it is never spilled
+        while (m_linesInMemory > m_maxLinesInMemory && m_firstChunkInMemory + 1 < static_cast<int>(m_chunks.size())
+               && spill(m_chunks[m_firstChunkInMemory])) {
+            ++m_firstChunkInMemory;
+            m_linesInMemory -= LINES_PER_CHUNK;
+        }
+    }
+
+    QString line(int row) const
+    {
+        const auto& chunk = m_chunks[row / LINES_PER_CHUNK];
+        const int index = row % LINES_PER_CHUNK;
+        const auto start = chunk.lineStarts[index];
+        const auto size = chunk.lineStarts[index + 1] - start;
+        const char* const text = chunk.mappedText ? chunk.mappedText : chunk.text.constData();
+        return QString::fromUtf8(text + start, size);
+    }
+
+    FilteredItem::FilteredOutputItemType type(int row) const
     {
-        m_timer->setInterval(BATCH_AGGREGATE_TIME_DELAY);
-        m_timer->setSingleShot(true);
-        connect(m_timer, &QTimer::timeout, this, &ParseWorker::process);
+        return static_cast<FilteredItem::FilteredOutputItemType>(
+            m_chunks[row / LINES_PER_CHUNK].types[row % LINES_PER_CHUNK]);
     }
 
-public Q_SLOTS:
-    void changeFilterStrategy( KDevelop::IFilterStrategy* newFilterStrategy )
+    void setMaxLinesInMemory(int maxLines)
     {
-        m_filter = QSharedPointer<IFilterStrategy>( newFilterStrategy );
+        m_maxLinesInMemory = maxLines;
     }
 
-    void addLines( const QStringList& lines )
+    void clear()
     {
-        m_cachedLines << lines;
-
-        if (m_cachedLines.size() >= BATCH_SIZE) {
-            // if enough lines were added, process immediately
-            m_timer->stop();
-            process();
-        } else if (!m_timer->isActive()) {
-            m_timer->start();
+        m_chunks.clear();
+        m_spillFile.reset();
+        m_spillFailed = false;
+        m_size = 0;
+        m_linesInMemory = 0;
+        m_firstChunkInMemory = 0;
+    }
+
+private:
+    struct Chunk
+    {
+        /// the UTF-8 text of the lines, while the chunk is in memory
+        QByteArray text;
+        /// the text of the lines in the temporary file, once the chunk is spilled
+        const char* mappedText = nullptr;
+        /// the offsets of the lines in the text, followed by the end of the last line
+        QVector<quint32> lineStarts;
+        QByteArray types;
+    };
+
+    bool spill(Chunk& chunk)
+    {
+        if (m_spillFailed) {
+            return false;
+        }
+        if (!m_spillFile) {
+            m_spillFile = std::make_unique<QTemporaryFile>();
+            if (!m_spillFile->open()) {
+                qCWarning(OUTPUTVIEW) << "cannot create a file to store old output lines, keeping them in memory:"
+                                      << m_spillFile->errorString();
+                m_spillFailed = true;
+                return false;
+            }
         }
+        if (chunk.text.isEmpty()) {
+            // empty lines only, nothing to map
+            chunk.text = QByteArray();
+            chunk.mappedText = "";
+            return true;
+        }
+
+        const qint64 offset = m_spillFile->size();
+        uchar* mapped = nullptr;
+        if (m_spillFile->write(chunk.text) == chunk.text.size() && m_spillFile->flush()) {
+            mapped = m_spillFile->map(offset, chunk.text.size());
+        }
+        if (!mapped) {
+            qCWarning(OUTPUTVIEW) << "cannot store old output lines in" << m_spillFile->fileName()
+                                  << ", keeping them in memory:" << m_spillFile->errorString();
+            m_spillFailed = true;
+            return false;
+        }
+        chunk.mappedText = reinterpret_cast<const char*>(mapped);
+        chunk.text = QByteArray();
+        return true;
+    }
+
+    std::vector<Chunk> m_chunks;
+    std::unique_ptr<QTemporaryFile> m_spillFile;
+    bool m_spillFailed = false;
+    int m_size = 0;
+    int m_maxLinesInMemory = DEFAULT_MAX_LINES_IN_MEMORY;
+    int m_linesInMemory = 0;
+    int m_firstChunkInMemory = 0;
+};
+
+class ParsingThreadPool : public QThreadPool
+{
+public:
+    ParsingThreadPool()
+    {
+        setObjectName(QStringLiteral("OutputFilterThread"));
+    }
+};
+
+Q_GLOBAL_STATIC(ParsingThreadPool, s_parsingThreadPool)
+
+/**
+ * Parses the lines of one model with its filter strategy.
+ *
+ * The lines are processed in order by at most one task of the parsing thread pool at a time,
+ * so that many models can parse their output in parallel. The results are picked up by the
+ * model in the GUI thread.
+ */
+class ParseWorker : public std::enable_shared_from_this<ParseWorker>
+{
+public:
+    struct Results
+    {
+        QVector<FilteredItem> items;
+        std::optional<IFilterStrategy::Progress> progress;
+    };
+
+    explicit ParseWorker(OutputModelPrivate* model)
+        : m_model(model)
+    {
+    }
+
+    void changeFilterStrategy(IFilterStrategy* newFilterStrategy)
+    {
+        QMutexLocker lock(&m_mutex);
+        // the new strategy applies to the lines added after it
+        m_pending.push_back({{}, 0, QSharedPointer<IFilterStrategy>(newFilterStrategy)});
+        startIfIdle();
     }
 
-    void flushBuffers()
+    void addLines(const QStringList& lines)
     {
-        m_timer->stop();
-        process();
-        emit allDone();
+        QMutexLocker lock(&m_mutex);
+        m_pending.push_back({lines, 0, {}});
+        m_pendingLineCount += lines.size();
+        startIfIdle();
     }
 
-Q_SIGNALS:
-    void parsedBatch(const QVector<KDevelop::FilteredItem>& filteredItems);
-    void progress(const KDevelop::IFilterStrategy::Progress& progress);
-    void allDone();
+    /// Stops processing lines and passing on results, to be called when the model is destroyed
+    void detach()
+    {
+        QMutexLocker lock(&m_mutex);
+        m_model = nullptr;
+        m_pending.clear();
+    }
+
+    Results takeResults()
+    {
+        QMutexLocker lock(&m_mutex);
+        m_notified = false;
+        Results results;
+        results.items.swap(m_results);
+        std::swap(results.progress, m_newProgress);
+        return results;
+    }
+
+private:
+    struct PendingLines
+    {
+        QStringList lines;
+        int processedCount;
+        QSharedPointer<IFilterStrategy> filter;
+    };
+
+    void startIfIdle()
+    {
+        if (!m_running && m_model) {
+            m_running = true;
+            s_parsingThreadPool->start([self = shared_from_this()] {
+                self->run();
+            });
+        }
+    }
+
+    /// Processes one batch of lines, and queues another task for the rest, so that a model with
+    /// a lot of output does not keep a thread of the pool away from the other models
+    void run()
+    {
+        QStringList lines;
+        {
+            QMutexLocker lock(&m_mutex);
+            if (m_pending.empty() || !m_model) {
+                m_running = false;
+                return;
+            }
+            auto& pending = m_pending.front();
+            if (pending.filter) {
+                m_filter = std::move(pending.filter);
+            }
+
+            // follow the line rate: many waiting lines are taken in larger batches, which saves
+            // locking and notifications, while few lines are passed on quickly
+            if (m_pendingLineCount > 2 * m_batchSize) {
+                m_batchSize = std::min(2 * m_batchSize, MAX_BATCH_SIZE);
+            } else if (m_pendingLineCount < m_batchSize / 2) {
+                m_batchSize = std::max(m_batchSize / 2, MIN_BATCH_SIZE);
+            }
+
+            const int count = std::min<int>(m_batchSize, pending.lines.size() - pending.processedCount);
+            lines = pending.lines.mid(pending.processedCount, count);
+            pending.processedCount += count;
+            m_pendingLineCount -= count;
+            if (pending.processedCount == pending.lines.size()) {
+                m_pending.pop_front();
+            }
+        }
+        if (!lines.isEmpty()) {
+            process(lines);
+        }
+
+        QMutexLocker lock(&m_mutex);
+        m_running = false;
+        if (!m_pending.empty()) {
+            startIfIdle();
+        }
+    }
 
-private Q_SLOTS:
-    /**
-     * Process *all* cached lines, emit parsedBatch for each batch
-     */
-    void process()
+    void process(QStringList& lines)
     {
         QVector<KDevelop::FilteredItem> filteredItems;
-        filteredItems.reserve(qMin(BATCH_SIZE, m_cachedLines.size()));
+        filteredItems.reserve(lines.size());
+        std::optional<IFilterStrategy::Progress> newProgress;
 
         // apply pre-filtering functions
-        std::transform(m_cachedLines.constBegin(), m_cachedLines.constEnd(),
-                       m_cachedLines.begin(), &KDevelop::stripAnsiSequences);
+        std::transform(lines.constBegin(), lines.constEnd(), lines.begin(), &KDevelop::stripAnsiSequences);
 
         // apply filtering strategy
-        for (const QString& line : std::as_const(m_cachedLines)) {
+        for (const QString& line : std::as_const(lines)) {
             FilteredItem item = m_filter->errorInLine(line);
             if( item.type == FilteredItem::InvalidItem ) {
                 item = m_filter->actionInLine(line);
@@ -111,57 +336,42 @@ private Q_SLOTS:
             auto progress = m_filter->progressInLine(line);
             if (progress.percent >= 0 && m_progress.percent != progress.percent) {
                 m_progress = progress;
-                emit this->progress(m_progress);
-            }
-
-            if( filteredItems.size() == BATCH_SIZE ) {
-                emit parsedBatch(filteredItems);
-                filteredItems.clear();
-                filteredItems.reserve(qMin(BATCH_SIZE, m_cachedLines.size()));
+                newProgress = progress;
             }
         }
 
-        // Make sure to emit the rest as well
-        if( !filteredItems.isEmpty() ) {
-            emit parsedBatch(filteredItems);
+        QMutexLocker lock(&m_mutex);
+        if (!m_model) {
+            return;
         }
-        m_cachedLines.clear();
-    }
-
-private:
-    QSharedPointer<IFilterStrategy> m_filter;
-    QStringList m_cachedLines;
-
-    QTimer* m_timer;
-    IFilterStrategy::Progress m_progress;
-};
-
-class ParsingThread
-{
-public:
-    ParsingThread()
-    {
-        m_thread.setObjectName(QStringLiteral("OutputFilterThread"));
-    }
-    virtual ~ParsingThread()
-    {
-        if (m_thread.isRunning()) {
-            m_thread.quit();
-            m_thread.wait();
+        m_results += filteredItems;
+        if (newProgress) {
+            m_newProgress = newProgress;
         }
-    }
-    void addWorker(ParseWorker* worker)
-    {
-        if (!m_thread.isRunning()) {
-            m_thread.start();
+        if (!m_notified) {
+            m_notified = true;
+            notifyModel();
         }
-        worker->moveToThread(&m_thread);
     }
-private:
-    QThread m_thread;
-};
 
-Q_GLOBAL_STATIC(ParsingThread, s_parsingThread)
+    /// Called with the mutex locked, which keeps the model alive
+    void notifyModel();
+
+    QMutex m_mutex;
+    // the state below is guarded by the mutex
+    OutputModelPrivate* m_model;
+    std::deque<PendingLines> m_pending;
+    int m_pendingLineCount = 0;
+    bool m_running = false;
+    QVector<FilteredItem> m_results;
+    std::optional<IFilterStrategy::Progress> m_newProgress;
+    bool m_notified = false;
+
+    // the state below is only used by the running task
+    QSharedPointer<IFilterStrategy> m_filter{new NoFilterStrategy};
+    IFilterStrategy::Progress m_progress;
+    int m_batchSize = MIN_BATCH_SIZE;
+};
 
 class OutputModelPrivate
 {
@@ -171,45 +381,93 @@ public:
     bool isValidIndex( const QModelIndex&, int currentRowCount ) const;
 
     OutputModel* model;
-    ParseWorker* worker;
+    const std::shared_ptr<ParseWorker> worker;
 
-    QVector<FilteredItem> m_filteredItems;
+    struct ItemLocation
+    {
+        QUrl url;
+        int lineNo;
+        int columnNo;
+    };
+
+    OutputLineStorage m_lines;
     // We use std::set because that is ordered
     std::set<int> m_errorItems; // Indices of all items that we want to move to using previous and next
+    // The locations of the activatable items, by their index. Only these few items need more than their text and type.
+    std::map<int, ItemLocation> m_activatableItems;
     QUrl m_buildDir;
 
+    QTimer m_insertionTimer;
+    QElapsedTimer m_sinceLastInsertion;
+    /// the count of lines appended to the model, and parsed and inserted so far, including the cleared ones
+    qint64 m_appendedLineCount = 0;
+    qint64 m_parsedLineCount = 0;
+    /// the line counts after which allDone() is due, as requested by ensureAllDone()
+    std::deque<qint64> m_allDoneLineCounts;
+
+    /// Inserts the lines parsed in the meantime at the next insertion time
+    void scheduleInsertion()
+    {
+        if (!m_insertionTimer.isActive()) {
+            const auto elapsed = m_sinceLastInsertion.isValid() ? m_sinceLastInsertion.elapsed() : INSERTION_INTERVAL;
+            m_insertionTimer.start(std::max<int>(0, INSERTION_INTERVAL - elapsed));
+        }
+    }
+
+    void insertParsedLines()
+    {
+        m_sinceLastInsertion.start();
+        const auto results = worker->takeResults();
+        if (!results.items.isEmpty()) {
+            linesParsed(results.items);
+        }
+        if (results.progress) {
+            emit model->progress(*results.progress);
+        }
+        while (!m_allDoneLineCounts.empty() && m_allDoneLineCounts.front() <= m_parsedLineCount) {
+            m_allDoneLineCounts.pop_front();
+            emit model->allDone();
+        }
+    }
+
     void linesParsed(const QVector<KDevelop::FilteredItem>& items)
     {
         model->beginInsertRows( QModelIndex(), model->rowCount(), model->rowCount() + items.size() -  1);
 
-        m_filteredItems.reserve(m_filteredItems.size() + items.size());
+        m_parsedLineCount += items.size();
+
         for (const FilteredItem& item : items) {
             if( item.type == FilteredItem::ErrorItem ) {
-                m_errorItems.insert(m_filteredItems.size());
+                m_errorItems.insert(m_lines.size());
+            }
+            if (item.isActivatable) {
+                m_activatableItems.emplace_hint(m_activatableItems.end(), m_lines.size(),
+                                                ItemLocation{item.url, item.lineNo, item.columnNo});
             }
-            m_filteredItems << item;
+            m_lines.append(item.originalLine, item.type);
         }
 
         model->endInsertRows();
     }
 };
 
+void ParseWorker::notifyModel()
+{
+    if (m_model) {
+        auto* const model = m_model;
+        QMetaObject::invokeMethod(model->model, [model] { model->scheduleInsertion(); }, Qt::QueuedConnection);
+    }
+}
+
 OutputModelPrivate::OutputModelPrivate( OutputModel* model_, const QUrl& builddir)
 : model(model_)
-, worker(new ParseWorker )
+, worker(std::make_shared<ParseWorker>(this))
 , m_buildDir( builddir )
 {
-    qRegisterMetaType<QVector<KDevelop::FilteredItem> >();
-    qRegisterMetaType<KDevelop::IFilterStrategy*>();
     qRegisterMetaType<KDevelop::IFilterStrategy::Progress>();
 
-    s_parsingThread->addWorker(worker);
-    model->connect(worker, &ParseWorker::parsedBatch,
-                   model, [=] (const QVector<KDevelop::FilteredItem>& items) { linesParsed(items); });
-    model->connect(worker, &ParseWorker::allDone,
-                   model, &OutputModel::allDone);
-    model->connect(worker, &ParseWorker::progress,
-                   model, &OutputModel::progress);
+    m_insertionTimer.setSingleShot(true);
+    model->connect(&m_insertionTimer, &QTimer::timeout, model, [this] { insertParsedLines(); });
 }
 
 bool OutputModelPrivate::isValidIndex( const QModelIndex& idx, int currentRowCount ) const
@@ -219,7 +477,7 @@ bool OutputModelPrivate::isValidIndex( const QModelIndex& idx, int currentRowCou
 
 OutputModelPrivate::~OutputModelPrivate()
 {
-    worker->deleteLater();
+    worker->detach();
 }
 
 OutputModel::OutputModel( const QUrl& builddir, QObject* parent )
@@ -245,9 +503,9 @@ QVariant OutputModel::data(const QModelIndex& idx , int role ) const
         switch( role )
         {
             case Qt::DisplayRole:
-                return d->m_filteredItems.at( idx.row() ).originalLine;
+                return d->m_lines.line(idx.row());
             case OutputModel::OutputItemTypeRole:
-                return static_cast<int>(d->m_filteredItems.at( idx.row() ).type);
+                return static_cast<int>(d->m_lines.type(idx.row()));
             case Qt::FontRole:
                 return QFontDatabase::systemFont(QFontDatabase::FixedFont);
         }
@@ -260,7 +518,7 @@ int OutputModel::rowCount( const QModelIndex& parent ) const
     Q_D(const OutputModel);
 
     if( !parent.isValid() )
-        return d->m_filteredItems.count();
+        return d->m_lines.size();
     return 0;
 }
 
@@ -280,9 +538,10 @@ void OutputModel::activate( const QModelIndex& index )
     qCDebug(OUTPUTVIEW) << "Model activated" << index.row();
 
 
-    FilteredItem item = d->m_filteredItems.at( index.row() );
-    if( item.isActivatable )
+    const auto itemIt = d->m_activatableItems.find(index.row());
+    if (itemIt != d->m_activatableItems.end())
     {
+        const auto& item = itemIt->second;
         qCDebug(OUTPUTVIEW) << "activating:" << item.lineNo << item.url;
         KTextEditor::Cursor range( item.lineNo, item.columnNo );
         KDevelop::IDocumentController *docCtrl = KDevelop::ICore::self()->documentController();
@@ -309,10 +568,8 @@ QModelIndex OutputModel::firstHighlightIndex()
         return index( *d->m_errorItems.begin(), 0, QModelIndex() );
     }
 
-    for( int row = 0; row < rowCount(); ++row ) {
-        if( d->m_filteredItems.at( row ).isActivatable ) {
-            return index( row, 0, QModelIndex() );
-        }
+    if (!d->m_activatableItems.empty()) {
+        return index(d->m_activatableItems.begin()->first, 0, QModelIndex());
     }
 
     return QModelIndex();
@@ -335,13 +592,12 @@ QModelIndex OutputModel::nextHighlightIndex( const QModelIndex &currentIdx )
         return index( *next, 0, QModelIndex() );
     }
 
-    for( int row = 0; row < rowCount(); ++row )
-    {
-        int currow = (startrow + row) % rowCount();
-        if( d->m_filteredItems.at( currow ).isActivatable )
-        {
-            return index( currow, 0, QModelIndex() );
-        }
+    if (!d->m_activatableItems.empty()) {
+        auto next = d->m_activatableItems.lower_bound(startrow);
+        if (next == d->m_activatableItems.end())
+            next = d->m_activatableItems.begin();
+
+        return index(next->first, 0, QModelIndex());
     }
     return QModelIndex();
 }
@@ -350,9 +606,6 @@ QModelIndex OutputModel::previousHighlightIndex( const QModelIndex &currentIdx )
 {
     Q_D(OutputModel);
 
-    //We have to ensure that startrow is >= rowCount - 1 to get a positive value from the % operation.
-    int startrow = rowCount() + (d->isValidIndex(currentIdx, rowCount()) ? currentIdx.row() : rowCount()) - 1;
-
     if(!d->m_errorItems.empty())
     {
         qCDebug(OUTPUTVIEW) << "searching previous error";
@@ -368,13 +621,17 @@ QModelIndex OutputModel::previousHighlightIndex( const QModelIndex &currentIdx )
         return index( *previous, 0, QModelIndex() );
     }
 
-    for ( int row = 0; row < rowCount(); ++row )
-    {
-        int currow = (startrow - row) % rowCount();
-        if( d->m_filteredItems.at( currow ).isActivatable )
-        {
-            return index( currow, 0, QModelIndex() );
-        }
+    if (!d->m_activatableItems.empty()) {
+        // Jump to the previous activatable item before the current one, or to the last one
+        const int endrow = d->isValidIndex(currentIdx, rowCount()) ? currentIdx.row() : rowCount();
+        auto previous = d->m_activatableItems.lower_bound(endrow);
+
+        if (previous == d->m_activatableItems.begin())
+            previous = d->m_activatableItems.end();
+
+        --previous;
+
+        return index(previous->first, 0, QModelIndex());
     }
     return QModelIndex();
 }
@@ -387,10 +644,8 @@ QModelIndex OutputModel::lastHighlightIndex()
         return index( *d->m_errorItems.rbegin(), 0, QModelIndex() );
     }
 
-    for( int row = rowCount()-1; row >=0; --row ) {
-        if( d->m_filteredItems.at( row ).isActivatable ) {
-            return index( row, 0, QModelIndex() );
-        }
+    if (!d->m_activatableItems.empty()) {
+        return index(d->m_activatableItems.rbegin()->first, 0, QModelIndex());
     }
 
     return QModelIndex();
@@ -424,16 +679,14 @@ void OutputModel::setFilteringStrategy(const OutputFilterStrategy& currentStrate
         filter = new NoFilterStrategy;
     }
 
-    QMetaObject::invokeMethod(d->worker, "changeFilterStrategy",
-                              Q_ARG(KDevelop::IFilterStrategy*, filter));
+    d->worker->changeFilterStrategy(filter);
 }
 
 void OutputModel::setFilteringStrategy(IFilterStrategy* filterStrategy)
 {
     Q_D(OutputModel);
 
-    QMetaObject::invokeMethod(d->worker, "changeFilterStrategy",
-                              Q_ARG(KDevelop::IFilterStrategy*, filterStrategy));
+    d->worker->changeFilterStrategy(filterStrategy);
 }
 
 void OutputModel::appendLines( const QStringList& lines )
@@ -443,8 +696,8 @@ void OutputModel::appendLines( const QStringList& lines )
     if( lines.isEmpty() )
         return;
 
-    QMetaObject::invokeMethod(d->worker, "addLines",
-                              Q_ARG(QStringList, lines));
+    d->m_appendedLineCount += lines.size();
+    d->worker->addLines(lines);
 }
 
 void OutputModel::appendLine( const QString& line )
@@ -456,7 +709,9 @@ void OutputModel::ensureAllDone()
 {
     Q_D(OutputModel);
 
-    QMetaObject::invokeMethod(d->worker, "flushBuffers");
+    d->m_allDoneLineCounts.push_back(d->m_appendedLineCount);
+    // allDone() is emitted with the insertion of the last appended lines, or right after if they are inserted already
+    d->scheduleInsertion();
 }
 
 void OutputModel::clear()
@@ -465,11 +720,19 @@ void OutputModel::clear()
 
     ensureAllDone();
     beginResetModel();
-    d->m_filteredItems.clear();
+    d->m_lines.clear();
+    d->m_errorItems.clear();
+    d->m_activatableItems.clear();
     endResetModel();
 }
 
+void OutputModel::setMaxLinesInMemory(int maxLines)
+{
+    Q_D(OutputModel);
+
+    d->m_lines.setMaxLinesInMemory(maxLines);
+}
+
 }
 
-#include "outputmodel.moc"
 #include "moc_outputmodel.cpp"
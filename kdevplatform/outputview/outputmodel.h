@@ -60,6 +60,13 @@ public:
     void setFilteringStrategy(const OutputFilterStrategy& currentStrategy);
     void setFilteringStrategy(IFilterStrategy* filterStrategy);
 
+    /**
+     * Sets how many lines of output are kept in memory, the text of older lines is moved to a
+     * temporary file. The locations of errors and other activatable lines are always kept in memory.
+     * By default 100000 lines are kept in memory.
+     */
+    void setMaxLinesInMemory(int maxLines);
+
 public Q_SLOTS:
     void appendLine( const QString& );
     void appendLines( const QStringList& );
@@ -10,6 +10,7 @@
 
 #include <outputview/outputfilteringstrategies.h>
 #include <outputview/filtereditem.h>
+#include <outputview/outputformats.h>
 #include <util/path.h>
 
 #include <QElapsedTimer>
@@ -570,6 +571,49 @@ void TestFilteringStrategy::benchMarkCompilerFilterAction()
     QVERIFY(avgDirectoryInsertion < 2);
 }
 
+void TestFilteringStrategy::benchMarkCompilerFilterBuildLog()
+{
+    // mostly progress lines of a parallel build, with a warning every now and then
+    QString projecturl = projectPath();
+    QStringList outputlines;
+    const int numLines(10000);
+    int j(0);
+    do {
+        ++j;
+        outputlines << QStringLiteral("[%1/%2] Building CXX object src/CMakeFiles/foo.dir/file%1.cpp.o").arg(j).arg(numLines);
+        if(j % 20 == 0) {
+            outputlines << QString(projecturl + "/src/file%1.cpp:42:13: warning: unused parameter 'x' [-Wunused-parameter]").arg(j)
+                        << QStringLiteral("   42 | void foo(int x) {}")
+                        << QStringLiteral("      |         ~~~~^");
+        }
+    }
+    while(outputlines.size() < numLines ); // gives us numLines (-ish)
+
+    QElapsedTimer totalTime;
+    totalTime.start();
+
+    CompilerFilterStrategy testee(QUrl::fromLocalFile(projecturl));
+    FilteredItem item1(QStringLiteral("dummyline"), FilteredItem::InvalidItem);
+    QBENCHMARK {
+        // the same order as in the output model
+        for(int i = 0; i < outputlines.size(); ++i) {
+            item1 = testee.errorInLine(outputlines.at(i));
+            if (item1.type == FilteredItem::InvalidItem) {
+                item1 = testee.actionInLine(outputlines.at(i));
+            }
+        }
+    }
+
+    const qint64 elapsed = totalTime.elapsed();
+
+    qDebug() << "ms elapsed to filter lines: " << elapsed;
+    qDebug() << "total number of lines: " << outputlines.count();
+    const double avgLineFiltering = double(elapsed) / outputlines.count();
+    qDebug() << "average ms spend pr. line: " << avgLineFiltering;
+
+    QVERIFY(avgLineFiltering < 2);
+}
+
 void TestFilteringStrategy::testExtractionOfLineAndColumn_data()
 {
     QTest::addColumn<QString>("line");
@@ -647,4 +691,207 @@ void TestFilteringStrategy::testExtractionOfLineAndColumn()
     QCOMPARE(item1.columnNo , column);
 }
 
+void TestFilteringStrategy::testRequiredLiteral_data()
+{
+    QTest::addColumn<QRegularExpression>("expression");
+    QTest::addColumn<QString>("literal");
+
+    QTest::newRow("plain") << QRegularExpression(QStringLiteral("No rule to make target")) << QStringLiteral("No rule to make target");
+    QTest::newRow("question after literal") << QRegularExpression(QStringLiteral("colou?r")) << QStringLiteral("colo");
+    QTest::newRow("star after literal") << QRegularExpression(QStringLiteral("abcd*ef")) << QStringLiteral("abc");
+    QTest::newRow("plus after literal") << QRegularExpression(QStringLiteral("abc+d")) << QStringLiteral("abc");
+    QTest::newRow("lazy quantifier") << QRegularExpression(QStringLiteral("abcd*?ef")) << QStringLiteral("abc");
+    QTest::newRow("counted quantifier") << QRegularExpression(QStringLiteral("abcd{2,3}ef")) << QStringLiteral("abc");
+    QTest::newRow("counted quantifier after class") << QRegularExpression(QStringLiteral("abc[0-9]{2}de")) << QStringLiteral("abc");
+    QTest::newRow("escaped punctuation") << QRegularExpression(QStringLiteral("\\[javac\\]")) << QStringLiteral("[javac]");
+    QTest::newRow("quantified escape") << QRegularExpression(QStringLiteral("abc\\.?d")) << QStringLiteral("abc");
+    QTest::newRow("escaped character class") << QRegularExpression(QStringLiteral("foo\\d+barbaz")) << QStringLiteral("barbaz");
+    QTest::newRow("unsupported escape") << QRegularExpression(QStringLiteral("foo\\x41bar")) << QString();
+    QTest::newRow("group") << QRegularExpression(QStringLiteral("abc(defghij)kl")) << QStringLiteral("abc");
+    QTest::newRow("nested group") << QRegularExpression(QStringLiteral("a(b(cdef)g)hij")) << QStringLiteral("hij");
+    QTest::newRow("quantified group") << QRegularExpression(QStringLiteral("abc(def)?gh")) << QStringLiteral("abc");
+    QTest::newRow("non-capturing group") << QRegularExpression(QStringLiteral("(?:abcdef)xy")) << QStringLiteral("xy");
+    QTest::newRow("lookahead") << QRegularExpression(QStringLiteral("(?=abcdef)xyz")) << QStringLiteral("xyz");
+    QTest::newRow("alternation in group") << QRegularExpression(QStringLiteral("(foo|bar)baz")) << QStringLiteral("baz");
+    QTest::newRow("top-level alternation") << QRegularExpression(QStringLiteral("foo|bar")) << QString();
+    QTest::newRow("inline option") << QRegularExpression(QStringLiteral("(?i)error")) << QString();
+    QTest::newRow("character class") << QRegularExpression(QStringLiteral("ab[cdef]ghi")) << QStringLiteral("ghi");
+    QTest::newRow("class starting with bracket") << QRegularExpression(QStringLiteral("ab[]cdef]ghi")) << QStringLiteral("ghi");
+    QTest::newRow("negated class starting with bracket") << QRegularExpression(QStringLiteral("ab[^]cdef]ghi")) << QStringLiteral("ghi");
+    QTest::newRow("escaped bracket in class") << QRegularExpression(QStringLiteral("ab[\\]cdef]ghi")) << QStringLiteral("ghi");
+    QTest::newRow("posix class") << QRegularExpression(QStringLiteral("ab[[:alpha:]]ghi")) << QStringLiteral("ghi");
+    QTest::newRow("dot and anchors") << QRegularExpression(QStringLiteral("^abc.de$")) << QStringLiteral("abc");
+    QTest::newRow("non-ascii") << QRegularExpression(QStringLiteral("abc\u00e4de")) << QStringLiteral("abc");
+    QTest::newRow("no literal") << QRegularExpression(QStringLiteral("^(.*)$")) << QString();
+    QTest::newRow("case insensitive") << QRegularExpression(QStringLiteral("error"), QRegularExpression::CaseInsensitiveOption)
+        << QString();
+}
+
+void TestFilteringStrategy::testRequiredLiteral()
+{
+    QFETCH(QRegularExpression, expression);
+    QFETCH(QString, literal);
+
+    QVERIFY(expression.isValid());
+    QCOMPARE(requiredLiteral(expression), literal);
+}
+
+void TestFilteringStrategy::testRequiredLiteralOfFilters_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("literal");
+    QTest::addColumn<QString>("line");
+
+    // the expressions of CompilerFilterStrategy, with a line each of them matches
+    QTest::newRow("action-compile") << QStringLiteral("(?:^|[^=])\\b(gcc|CC|cc|distcc|c\\+\\+|g\\+\\+|clang(?:\\+\\+)|mpicc|icc|icpc)\\s+.*-c.*[/ '\\\\]+(\\w+\\.(?:cpp|CPP|c|C|cxx|CXX|cs|java|hpf|f|F|f90|F90|f95|F95))") << QStringLiteral("-c")
+        << QStringLiteral("gcc -c /src/foo.cpp");
+    QTest::newRow("action-moc") << QStringLiteral("/(moc|uic)\\b.*\\s-o\\s([^\\s;]+)") << QStringLiteral("-o")
+        << QStringLiteral("/usr/bin/moc foo.h -o moc_foo.cpp");
+    QTest::newRow("action-libtool-link") << QStringLiteral("/bin/sh\\s.*libtool.*--mode=link\\s.*\\s-o\\s([^\\s;]+)") << QStringLiteral("--mode=link")
+        << QStringLiteral("/bin/sh ../libtool --mode=link g++ -o libfoo.la foo.lo");
+    QTest::newRow("action-compiling") << QStringLiteral("^compiling (.*)") << QStringLiteral("compiling ")
+        << QStringLiteral("compiling foo.cpp");
+    QTest::newRow("action-generating") << QStringLiteral("^generating (.*)") << QStringLiteral("generating ")
+        << QStringLiteral("generating foo.moc");
+    QTest::newRow("action-link") << QStringLiteral("(gcc|cc|c\\+\\+|g\\+\\+|clang(?:\\+\\+)|mpicc|icc|icpc)\\S* (?:\\S* )*-o ([^\\s;]+)") << QStringLiteral("-o ")
+        << QStringLiteral("g++ -g -o foo foo.o");
+    QTest::newRow("action-linking") << QStringLiteral("^linking (.*)") << QStringLiteral("linking ")
+        << QStringLiteral("linking foo");
+    QTest::newRow("action-cmake-built") << QStringLiteral("\\[.+%\\] Built target (.*)") << QStringLiteral("%] Built target ")
+        << QStringLiteral("[100%] Built target foo");
+    QTest::newRow("action-cmake-building") << QStringLiteral("\\[.+%\\] Building .* object (.*)") << QStringLiteral("%] Building ")
+        << QStringLiteral("[ 26%] Building CXX object foo/CMakeFiles/foo.dir/foo.cpp.o");
+    QTest::newRow("action-cmake-generating") << QStringLiteral("\\[.+%\\] Generating (.*)") << QStringLiteral("%] Generating ")
+        << QStringLiteral("[ 10%] Generating foo.moc");
+    QTest::newRow("action-cmake-linking") << QStringLiteral("^Linking (.*)") << QStringLiteral("Linking ")
+        << QStringLiteral("Linking CXX executable foo");
+    QTest::newRow("action-cmake-configure") << QStringLiteral("(-- (?:Configuring|Generating) (?:done|incomplete)|-- Found|-- Adding|-- Enabling)") << QString()
+        << QStringLiteral("-- Configuring done");
+    QTest::newRow("action-cmake-installing") << QStringLiteral("-- Installing (.*)") << QStringLiteral("-- Installing ")
+        << QStringLiteral("-- Installing /usr/local/bin/foo");
+    QTest::newRow("action-cmake-cd") << QStringLiteral("cmake(?:\\.exe|\\.bat)? (?:.*?) ((?:[A-Za-z]:|/).*$)") << QStringLiteral("cmake")
+        << QStringLiteral("/usr/bin/cmake -DCMAKE_BUILD_TYPE=Debug /home/user/project");
+    QTest::newRow("action-mkinstalldirs") << QStringLiteral("/(?:bin/sh\\s.*mkinstalldirs).*\\s([^\\s;]+)") << QStringLiteral("/")
+        << QStringLiteral("/bin/sh ../mkinstalldirs /usr/local/share");
+    QTest::newRow("action-install") << QStringLiteral("/(?:usr/bin/install|bin/sh\\s.*mkinstalldirs|bin/sh\\s.*libtool.*--mode=install).*\\s([^\\s;]+)") << QStringLiteral("/")
+        << QStringLiteral("/usr/bin/install -c foo /usr/local/bin/foo");
+    QTest::newRow("action-dcopidl") << QStringLiteral("dcopidl .* > ([^\\s;]+)") << QStringLiteral("dcopidl ")
+        << QStringLiteral("dcopidl foo.h > foo.kidl");
+    QTest::newRow("action-dcopidl2cpp") << QStringLiteral("dcopidl2cpp (?:\\S* )*([^\\s;]+)") << QStringLiteral("dcopidl2cpp ")
+        << QStringLiteral("dcopidl2cpp foo.kidl");
+    QTest::newRow("action-make-cd") << QStringLiteral("make\\[\\d+\\]: Entering directory (\\`|\\')(.+)'") << QStringLiteral("]: Entering directory ")
+        << QStringLiteral("make[1]: Entering directory '/home/user/project'");
+    QTest::newRow("action-waf-cd") << QStringLiteral("(Waf|scons): Entering directory (\\`|\\')(.+)'") << QStringLiteral(": Entering directory ")
+        << QStringLiteral("Waf: Entering directory `/home/user/project/build'");
+    QTest::newRow("error-msvc") << QStringLiteral("^([a-zA-Z]:\\\\.+)\\(([1-9][0-9]*)\\): ((?:error|warning) .+\\:).*$") << QStringLiteral("): ")
+        << QStringLiteral("C:\\project\\foo.cpp(42): error C2065: 'x': undeclared identifier");
+    QTest::newRow("error-gcc-column") << QStringLiteral("^(.:?[^:\\t]+):([0-9]+):([0-9]+):([^0-9]+)") << QStringLiteral(":")
+        << QStringLiteral("/home/user/foo.cpp:42:13: error: 'x' was not declared");
+    QTest::newRow("error-ant") << QStringLiteral("\\[javac\\][\\s]+([^:\\t]+):([0-9]+): (warning: .*|error: .*)") << QStringLiteral("[javac]")
+        << QStringLiteral("    [javac] /home/user/Foo.java:42: error: cannot find symbol");
+    QTest::newRow("error-gcc") << QStringLiteral("^(.:?[^:\\t]+):([0-9]+):([^0-9]+)") << QStringLiteral(":")
+        << QStringLiteral("/home/user/foo.cpp:42: error: foo");
+    QTest::newRow("error-gcc-included") << QStringLiteral("^(In file included from |[ ]+from )(..[^:\\t]+):([0-9]+)(:|,)(|[0-9]+)") << QStringLiteral(":")
+        << QStringLiteral("In file included from /home/user/foo.cpp:12:");
+    QTest::newRow("error-icc") << QStringLiteral("^(.:?[^:\\t]+)\\(([0-9]+)\\):([^0-9]+)") << QStringLiteral("):")
+        << QStringLiteral("/home/user/foo.cpp(42): error: foo");
+    QTest::newRow("error-libtool") << QStringLiteral("^(libtool):( link):( warning): ") << QStringLiteral(": ")
+        << QStringLiteral("libtool: link: warning: foo");
+    QTest::newRow("error-make") << QStringLiteral("No rule to make target") << QStringLiteral("No rule to make target")
+        << QStringLiteral("make: *** No rule to make target 'foo', needed by 'bar'.  Stop.");
+    QTest::newRow("error-cmake-multiline") << QStringLiteral("((^\\/|^[a-zA-Z]:)[\\w|\\/| |\\.]+):([0-9]+):") << QStringLiteral(":")
+        << QStringLiteral("/home/user/CMakeLists.txt:42:");
+    QTest::newRow("error-cmake") << QStringLiteral("CMake (Error|Warning) (|\\([a-zA-Z]+\\) )(in|at) ([^:]+):($|[0-9]+)") << QStringLiteral("CMake ")
+        << QStringLiteral("CMake Error at CMakeLists.txt:42 (add_executable):");
+    QTest::newRow("error-automoc") << QStringLiteral("^(AUTOMOC|AUTOGEN): error: (.*?) (The file .*)$") << QStringLiteral(": error: ")
+        << QStringLiteral("AUTOMOC: error: /foo/bar.cpp The file includes the moc file \"moc_bar.cpp\"");
+    QTest::newRow("error-automoc4") << QStringLiteral("^automoc4: The file \"([^\"]+)\" includes the moc file") << QStringLiteral("\" includes the moc file")
+        << QStringLiteral("automoc4: The file \"/foo/bar.cpp\" includes the moc file \"bar1.moc\", but");
+    QTest::newRow("error-fortran") << QStringLiteral("\"(.*)\", line ([0-9]+):(.*)") << QStringLiteral("\", line ")
+        << QStringLiteral("\"foo.f\", line 42: error");
+    QTest::newRow("error-gfortran") << QStringLiteral("^(.*):([0-9]+)\\.([0-9]+):(.*)") << QStringLiteral(":")
+        << QStringLiteral("foo.f90:42.13:");
+    QTest::newRow("error-jade") << QStringLiteral("^[a-zA-Z]+:([^:\\t]+):([0-9]+):[0-9]+:[a-zA-Z]:(.*)") << QStringLiteral(":")
+        << QStringLiteral("jade:foo.sgm:42:13:E: error");
+    QTest::newRow("error-ifort") << QStringLiteral("^fortcom: (.*): (.*), line ([0-9]+):(.*)") << QStringLiteral("fortcom: ")
+        << QStringLiteral("fortcom: Error: foo.f90, line 42: syntax error");
+    QTest::newRow("error-pgi") << QStringLiteral("PGF9(.*)-(.*)-(.*)-(.*) \\((.*): ([0-9]+)\\)") << QStringLiteral("PGF9")
+        << QStringLiteral("PGF90-S-0034-Syntax error at or near end of line (foo.f90: 42)");
+    QTest::newRow("error-pgi-symbol") << QStringLiteral("PGF9(.*)-(.*)-(.*)-Symbol, (.*) \\((.*)\\)") << QStringLiteral("-Symbol, ")
+        << QStringLiteral("PGF90-S-0038-Symbol, foo, has not been explicitly declared (foo.f90)");
+    QTest::newRow("error-tsc") << QStringLiteral("^(.*)\\(([0-9]+),([0-9]+)\\): ((?:[Ww]arning|[Ee]rror) TS[0-9]+: .*)") << QStringLiteral("): ")
+        << QStringLiteral("foo.ts(42,13): error TS2304: Cannot find name 'x'.");
+}
+
+void TestFilteringStrategy::testRequiredLiteralOfFilters()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, literal);
+    QFETCH(QString, line);
+
+    const ActionFormat format(0, pattern);
+    QVERIFY(format.expression.match(line).hasMatch());
+    QCOMPARE(format.literal, literal);
+    const FormatPrefilter prefilter(QVector<ActionFormat>{format});
+    QVERIFY(FormatPrefilter::isCandidate(prefilter.candidates(line), 0));
+}
+
+namespace {
+struct LiteralFormat
+{
+    QString literal;
+};
+}
+
+void TestFilteringStrategy::testFormatPrefilter_data()
+{
+    QTest::addColumn<QStringList>("literals");
+    QTest::addColumn<QString>("line");
+    QTest::addColumn<QList<int>>("candidates");
+
+    const QStringList literals{QStringLiteral("abc"), QStringLiteral("def")};
+    QTest::newRow("none") << literals << QStringLiteral("xyz") << QList<int>{};
+    QTest::newRow("one") << literals << QStringLiteral("xxabcxx") << QList<int>{0};
+    QTest::newRow("both") << literals << QStringLiteral("defabc") << QList<int>{0, 1};
+    QTest::newRow("case sensitive") << literals << QStringLiteral("ABC") << QList<int>{};
+    QTest::newRow("without literal") << QStringList{QStringLiteral("abc"), QString()} << QStringLiteral("xyz")
+                                     << QList<int>{1};
+    QTest::newRow("suffix of another") << QStringList{QStringLiteral("she"), QStringLiteral("he")}
+                                       << QStringLiteral("ashes") << QList<int>{0, 1};
+    QTest::newRow("overlapping")
+        << QStringList{QStringLiteral("hers"), QStringLiteral("his"), QStringLiteral("she"), QStringLiteral("he")}
+        << QStringLiteral("ushers") << QList<int>{0, 2, 3};
+    QTest::newRow("restarted match") << QStringList{QStringLiteral("aab")} << QStringLiteral("aaab") << QList<int>{0};
+    QTest::newRow("interrupted by non-ascii") << QStringList{QStringLiteral("abc")} << QStringLiteral("ab\u00e4c")
+                                              << QList<int>{};
+    QTest::newRow("after non-ascii") << QStringList{QStringLiteral("abc")} << QStringLiteral("\u00e4abc")
+                                     << QList<int>{0};
+    QTest::newRow("duplicates") << QStringList{QStringLiteral("abc"), QStringLiteral("abc")} << QStringLiteral("abc")
+                                << QList<int>{0, 1};
+    QStringList manyLiterals;
+    for (int i = 0; i < 64; ++i) {
+        manyLiterals << QStringLiteral("f%1").arg(i);
+    }
+    QTest::newRow("64 formats") << manyLiterals << QStringLiteral("f63") << QList<int>{6, 63};
+}
+
+void TestFilteringStrategy::testFormatPrefilter()
+{
+    QFETCH(QStringList, literals);
+    QFETCH(QString, line);
+    QFETCH(QList<int>, candidates);
+
+    QVector<LiteralFormat> formats;
+    for (const QString& literal : std::as_const(literals)) {
+        formats.append({literal});
+    }
+    FormatPrefilter::Candidates expected = 0;
+    for (const int format : std::as_const(candidates)) {
+        expected |= FormatPrefilter::Candidates{1} << format;
+    }
+
+    const FormatPrefilter prefilter(formats);
+    QCOMPARE(prefilter.candidates(line), expected);
+}
+
 #include "moc_test_filteringstrategy.cpp"
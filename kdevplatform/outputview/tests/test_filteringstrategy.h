@@ -33,8 +33,15 @@ private Q_SLOTS:
     void testStaticAnalysisFilterStrategy();
     void testExtractionOfLineAndColumn_data();
     void testExtractionOfLineAndColumn();
+    void testRequiredLiteral_data();
+    void testRequiredLiteral();
+    void testRequiredLiteralOfFilters_data();
+    void testRequiredLiteralOfFilters();
+    void testFormatPrefilter_data();
+    void testFormatPrefilter();
 
     void benchMarkCompilerFilterAction();
+    void benchMarkCompilerFilterBuildLog();
 };
 
 }
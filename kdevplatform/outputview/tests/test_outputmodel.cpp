@@ -8,8 +8,10 @@
 #include "test_outputmodel.h"
 #include "testlinebuilderfunctions.h"
 #include "../outputmodel.h"
+#include "../filtereditem.h"
 
 #include <QTest>
+#include <QSignalSpy>
 #include <QStandardPaths>
 #include <QElapsedTimer>
 
@@ -65,6 +67,146 @@ QStringList generateLongLine()
     return QStringList() << line;
 }
 
+void TestOutputModel::testLinesInTemporaryFile()
+{
+    OutputModel testee(QUrl::fromLocalFile(projectPath()));
+    testee.setFilteringStrategy(OutputModel::CompilerFilter);
+    testee.setMaxLinesInMemory(100);
+
+    const QString errorLine = buildCompilerErrorLine();
+    QStringList lines;
+    const int numLines = 20000;
+    for (int i = 0; i < numLines; ++i) {
+        // also some empty and non-ASCII lines
+        lines << (i == 5 ? errorLine : i % 1000 == 999 ? QString() : QStringLiteral("line %1 äöü").arg(i));
+    }
+
+    QSignalSpy allDoneSpy(&testee, &OutputModel::allDone);
+    testee.appendLines(lines);
+    testee.ensureAllDone();
+    QVERIFY(allDoneSpy.wait());
+    QCOMPARE(testee.rowCount(), numLines);
+
+    for (int row : {0, 5, 4095, 4096, 8191, 8192, 10000, 12345, numLines - 1}) {
+        QCOMPARE(testee.data(testee.index(row)).toString(), lines[row]);
+    }
+
+    // the error is still found after its text has been moved out of memory
+    const QModelIndex error = testee.nextHighlightIndex(testee.index(numLines - 1));
+    QCOMPARE(error.row(), 5);
+    QCOMPARE(testee.data(error, OutputModel::OutputItemTypeRole).toInt(), static_cast<int>(FilteredItem::ErrorItem));
+    QCOMPARE(testee.previousHighlightIndex(error).row(), 5);
+
+    testee.clear();
+    QCOMPARE(testee.rowCount(), 0);
+    QVERIFY(!testee.firstHighlightIndex().isValid());
+}
+
+void TestOutputModel::testLineOrder()
+{
+    OutputModel testee;
+
+    // many small appends, which are parsed in batches of varying size
+    QStringList lines;
+    for (int i = 0; i < 200; ++i) {
+        QStringList appended;
+        for (int j = 0; j < 50; ++j) {
+            appended << QStringLiteral("line %1").arg(lines.size() + j);
+        }
+        testee.appendLines(appended);
+        lines += appended;
+    }
+
+    QSignalSpy allDoneSpy(&testee, &OutputModel::allDone);
+    testee.ensureAllDone();
+    QVERIFY(allDoneSpy.wait());
+    QCOMPARE(testee.rowCount(), static_cast<int>(lines.size()));
+    for (int row = 0; row < lines.size(); ++row) {
+        QCOMPARE(testee.data(testee.index(row)).toString(), lines[row]);
+    }
+}
+
+void TestOutputModel::testFilterStrategyChangeOrder()
+{
+    OutputModel testee(QUrl::fromLocalFile(projectPath()));
+    const QString errorLine = buildCompilerErrorLine();
+
+    // a strategy applies to the lines appended after it was set, even when they are not parsed yet
+    testee.setFilteringStrategy(OutputModel::NoFilter);
+    testee.appendLines(QStringList(1000, QStringLiteral("line")) << errorLine);
+    testee.setFilteringStrategy(OutputModel::CompilerFilter);
+    testee.appendLine(errorLine);
+    testee.setFilteringStrategy(OutputModel::NoFilter);
+    testee.appendLine(errorLine);
+
+    QSignalSpy allDoneSpy(&testee, &OutputModel::allDone);
+    testee.ensureAllDone();
+    QVERIFY(allDoneSpy.wait());
+    QCOMPARE(testee.rowCount(), 1003);
+
+    const auto type = [&testee](int row) {
+        return testee.data(testee.index(row), OutputModel::OutputItemTypeRole).toInt();
+    };
+    const int errorItem = static_cast<int>(FilteredItem::ErrorItem);
+    QVERIFY(type(1000) != errorItem);
+    QCOMPARE(type(1001), errorItem);
+    QVERIFY(type(1002) != errorItem);
+}
+
+void TestOutputModel::testParallelModels()
+{
+    OutputModel first;
+    OutputModel second;
+    first.setFilteringStrategy(OutputModel::CompilerFilter);
+    second.setFilteringStrategy(OutputModel::CompilerFilter);
+
+    const QStringList lines = generateLines();
+    QSignalSpy firstDoneSpy(&first, &OutputModel::allDone);
+    QSignalSpy secondDoneSpy(&second, &OutputModel::allDone);
+    // interleaved, so that both models have lines waiting to be parsed at the same time
+    for (int i = 0; i < lines.size(); i += 100) {
+        first.appendLines(lines.mid(i, 100));
+        second.appendLines(lines.mid(i, 100));
+    }
+    first.ensureAllDone();
+    second.ensureAllDone();
+
+    QTRY_COMPARE(firstDoneSpy.count(), 1);
+    QTRY_COMPARE(secondDoneSpy.count(), 1);
+    for (const OutputModel* testee : {&first, &second}) {
+        QCOMPARE(testee->rowCount(), static_cast<int>(lines.size()));
+        for (int row = 0; row < lines.size(); ++row) {
+            QCOMPARE(testee->data(testee->index(row)).toString(), lines[row]);
+        }
+    }
+}
+
+void TestOutputModel::testAllDoneAfterEnsureAllDone()
+{
+    OutputModel testee;
+    QVector<int> rowCountsWhenDone;
+    connect(&testee, &OutputModel::allDone, this, [&testee, &rowCountsWhenDone] {
+        rowCountsWhenDone << testee.rowCount();
+    });
+
+    // nothing to wait for
+    testee.ensureAllDone();
+    QTRY_COMPARE(rowCountsWhenDone, QVector<int>{0});
+
+    // allDone() is only emitted once the lines appended before are inserted
+    testee.appendLines(QStringList(5000, QStringLiteral("line")));
+    testee.ensureAllDone();
+    testee.appendLines(QStringList(5000, QStringLiteral("line")));
+    testee.ensureAllDone();
+    QTRY_COMPARE(rowCountsWhenDone.size(), 3);
+    QVERIFY(rowCountsWhenDone[1] >= 5000);
+    QCOMPARE(rowCountsWhenDone[2], 10000);
+
+    // not emitted again without another request
+    QTest::qWait(100);
+    QCOMPARE(rowCountsWhenDone.size(), 3);
+}
+
 void TestOutputModel::bench()
 {
     QFETCH(KDevelop::OutputModel::OutputFilterStrategy, strategy);
@@ -21,6 +21,11 @@ public:
     explicit TestOutputModel(QObject* parent = nullptr);
 
 private Q_SLOTS:
+    void testLinesInTemporaryFile();
+    void testLineOrder();
+    void testFilterStrategyChangeOrder();
+    void testParallelModels();
+    void testAllDoneAfterEnsureAllDone();
     void bench();
     void bench_data();
 };
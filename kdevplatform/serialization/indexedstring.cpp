@@ -11,6 +11,12 @@
 #include "referencecounting.h"
 #include "repositorymanager.h"
 
+#include <QHash>
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
 #include <utility>
 
 using namespace KDevelop;
@@ -146,7 +152,56 @@ inline char indexToChar(uint index)
     return static_cast<char>(index & 0xff);
 }
 
-using IndexedStringRepository = ItemRepository<IndexedStringData, IndexedStringRepositoryItemRequest, false>;
+/**
+ * The strings are split over multiple repositories with their own lock, so that threads interning
+ * strings in parallel rarely contend. The repository a string is stored in is selected by its hash
+ * and encoded in the upper bits of the index, next to the index within that repository.
+ */
+constexpr uint shardBits = 2;
+constexpr uint shardCount = 1 << shardBits;
+constexpr uint shardShift = 32 - shardBits;
+constexpr uint localIndexMask = (1u << shardShift) - 1;
+// The bucket number must fit below the shard bits. The last bucket number is never used, such that
+// the local index of a single char index (see charToIndex) can't clash with a real one.
+constexpr int shardMaxBucketCount = (1 << (shardShift - 16)) - 1;
+
+inline uint shardForHash(uint hash)
+{
+    // the lower bits select the bucket hash slot within the repository, so mix the hash before taking the upper bits
+    return (hash * 2654435761u) >> shardShift;
+}
+
+inline uint shardForIndex(uint index)
+{
+    return index >> shardShift;
+}
+
+inline uint localIndex(uint index)
+{
+    return index & localIndexMask;
+}
+
+inline uint globalIndex(uint shard, uint indexInShard)
+{
+    Q_ASSERT(!(indexInShard & ~localIndexMask));
+    // keep the invalid zero index, e.g. when the repository is full
+    return indexInShard ? ((shard << shardShift) | indexInShard) : 0;
+}
+
+using IndexedStringRepository =
+    ItemRepository<IndexedStringData, IndexedStringRepositoryItemRequest, false, std::shared_mutex, 0,
+                   524288 * 2 / shardCount, shardMaxBucketCount>;
+
+struct IndexedStringRepositoryShard
+{
+    explicit IndexedStringRepositoryShard(uint shard)
+        : manager{QStringLiteral("String Index %1").arg(shard), &mutex}
+    {
+    }
+
+    std::shared_mutex mutex;
+    RepositoryManager<IndexedStringRepository, true, false> manager;
+};
 }
 
 namespace KDevelop
@@ -155,12 +210,17 @@ template<>
 class ItemRepositoryFor<IndexedString>
 {
     friend struct LockedItemRepository;
-    static IndexedStringRepository& repo()
+    static IndexedStringRepository& repo(uint shard)
     {
-        static QMutex mutex;
-        static RepositoryManager<IndexedStringRepository, true, false> manager { QStringLiteral("String Index"),
-                                                                                 &mutex };
-        return *manager.repository();
+        static const auto shards = [] {
+            std::array<std::unique_ptr<IndexedStringRepositoryShard>, shardCount> shards;
+            for (uint i = 0; i < shardCount; ++i) {
+                shards[i] = std::make_unique<IndexedStringRepositoryShard>(i);
+            }
+            return shards;
+        }();
+        Q_ASSERT(shard < shardCount);
+        return *shards[shard]->manager.repository();
     }
 };
 }
@@ -179,16 +239,11 @@ public:
         return {index, static_cast<Summand>(-1)}; // unsigned integer overflow is fine
     }
 
-    void editRepo() const
-    {
-        if (m_index && !isSingleCharIndex(m_index)) {
-            LockedItemRepository::write<IndexedString>(*this);
-        }
-    }
+    void editRepo() const;
 
     void operator()(IndexedStringRepository& repo) const
     {
-        repo.dynamicItemFromIndexSimple(m_index)->refCount += m_summand;
+        repo.dynamicItemFromIndexSimple(localIndex(m_index))->refCount += m_summand;
     }
 
 private:
@@ -202,6 +257,168 @@ private:
     unsigned m_index;
     Summand m_summand;
 };
+using ReferenceCount = decltype(IndexedStringData::refCount);
+
+std::atomic<quint64> internCacheHits{0};
+std::atomic<quint64> internCacheMisses{0};
+std::atomic<quint64> internCacheBatchedReferenceCountChanges{0};
+std::atomic<quint64> internCacheReferenceCountFlushes{0};
+
+/// The intern cache of a thread, see IndexedStringInternCache.
+class ThreadInternCache
+{
+public:
+    ThreadInternCache()
+        : m_entries(new Entry[entryCount])
+    {
+    }
+
+    ~ThreadInternCache()
+    {
+        flushReferenceCountChanges();
+
+        internCacheHits.fetch_add(m_statistics.hits, std::memory_order_relaxed);
+        internCacheMisses.fetch_add(m_statistics.misses, std::memory_order_relaxed);
+        internCacheBatchedReferenceCountChanges.fetch_add(m_statistics.batchedReferenceCountChanges,
+                                                          std::memory_order_relaxed);
+        internCacheReferenceCountFlushes.fetch_add(m_statistics.referenceCountFlushes, std::memory_order_relaxed);
+    }
+
+    static ThreadInternCache*& current()
+    {
+        static thread_local ThreadInternCache* cache = nullptr;
+        return cache;
+    }
+
+    /// @return the cached index of the string or 0 if it's not cached
+    uint find(const char* str, unsigned short length, uint hash)
+    {
+        const auto& entry = m_entries[hash & (entryCount - 1)];
+        if (entry.index && entry.hash == hash && entry.text.size() == length
+            && std::memcmp(entry.text.constData(), str, length) == 0) {
+            ++m_statistics.hits;
+            return entry.index;
+        }
+        ++m_statistics.misses;
+        return 0;
+    }
+
+    void insert(const char* str, unsigned short length, uint hash, uint index)
+    {
+        if (!index || length > maxCachedLength) {
+            return;
+        }
+        // direct mapped, i.e. a colliding string simply replaces the older one
+        auto& entry = m_entries[hash & (entryCount - 1)];
+        entry.hash = hash;
+        entry.index = index;
+        entry.text = QByteArray(str, length);
+    }
+
+    void changeReferenceCount(uint index, ReferenceCount summand)
+    {
+        m_referenceCountChanges[index] += summand; // unsigned integer overflow is fine
+        ++m_statistics.batchedReferenceCountChanges;
+        if (m_referenceCountChanges.size() >= maxReferenceCountChanges) {
+            flushReferenceCountChanges();
+        }
+    }
+
+    void flushReferenceCountChanges()
+    {
+        std::array<bool, shardCount> changedShards = {};
+        for (auto it = m_referenceCountChanges.cbegin(), end = m_referenceCountChanges.cend(); it != end; ++it) {
+            if (it.value()) {
+                changedShards[shardForIndex(it.key())] = true;
+            }
+        }
+
+        for (uint shard = 0; shard < shardCount; ++shard) {
+            if (!changedShards[shard]) {
+                continue;
+            }
+            LockedItemRepository::write<IndexedString>(
+                [this, shard](IndexedStringRepository& repo) {
+                    for (auto it = m_referenceCountChanges.cbegin(), end = m_referenceCountChanges.cend(); it != end;
+                         ++it) {
+                        if (it.value() && shardForIndex(it.key()) == shard) {
+                            repo.dynamicItemFromIndexSimple(localIndex(it.key()))->refCount += it.value();
+                        }
+                    }
+                },
+                shard);
+            ++m_statistics.referenceCountFlushes;
+        }
+        m_referenceCountChanges.clear();
+    }
+
+    int depth = 0;
+
+private:
+    // must be a power of two
+    static constexpr uint entryCount = 4096;
+    // longer strings are rarely interned repeatedly and would only evict the short ones
+    static constexpr unsigned short maxCachedLength = 256;
+    static constexpr int maxReferenceCountChanges = 1024;
+
+    struct Entry
+    {
+        uint hash = 0;
+        uint index = 0;
+        QByteArray text;
+    };
+
+    std::unique_ptr<Entry[]> m_entries;
+    QHash<uint, ReferenceCount> m_referenceCountChanges;
+    IndexedStringInternCache::Statistics m_statistics;
+};
+
+void ReferenceCountChanger::editRepo() const
+{
+    if (m_index && !isSingleCharIndex(m_index)) {
+        if (auto* const cache = ThreadInternCache::current()) {
+            cache->changeReferenceCount(m_index, m_summand);
+        } else {
+            LockedItemRepository::write<IndexedString>(*this, shardForIndex(m_index));
+        }
+    }
+}
+
+///@param str must be a utf8 encoded string of at least two bytes, does not need to be 0-terminated.
+uint internString(const char* str, unsigned short length, uint hash, bool refcount)
+{
+    if (!hash) {
+        hash = IndexedString::hashString(str, length);
+    }
+
+    auto* const cache = ThreadInternCache::current();
+    if (cache) {
+        if (const auto index = cache->find(str, length, hash)) {
+            if (refcount) {
+                cache->changeReferenceCount(index, 1);
+            }
+            return index;
+        }
+    }
+
+    const auto request = IndexedStringRepositoryItemRequest(str, hash, length);
+    const auto shard = shardForHash(hash);
+    const auto index = LockedItemRepository::write<IndexedString>(
+        [request, refcount, shard](IndexedStringRepository& repo) {
+            auto index = globalIndex(shard, repo.index(request));
+            if (refcount) {
+                ReferenceCountChanger::increase(index)(repo);
+            }
+            return index;
+        },
+        shard);
+
+    if (cache) {
+        cache->insert(str, length, hash, index);
+    }
+    return index;
+}
+
 inline void ref(unsigned index)
 {
     ReferenceCountChanger::increase(index).editRepo();
@@ -221,15 +438,7 @@ IndexedString::IndexedString(const char* str, unsigned short length, uint hash)
     } else if (length == 1) {
         m_index = charToIndex(str[0]);
     } else {
-        const auto request = IndexedStringRepositoryItemRequest(str, hash ? hash : hashString(str, length), length);
-        bool refcount = shouldDoDUChainReferenceCounting(this);
-        m_index = LockedItemRepository::write<IndexedString>([request, refcount](IndexedStringRepository& repo) {
-            auto index = repo.index(request);
-            if (refcount) {
-                ReferenceCountChanger::increase(index)(repo);
-            }
-            return index;
-        });
+        m_index = internString(str, length, hash, shouldDoDUChainReferenceCounting(this));
     }
 }
 
@@ -337,9 +546,11 @@ QString IndexedString::str() const
         return QString(QLatin1Char(indexToChar(m_index)));
     } else {
         const uint index = m_index;
-        return LockedItemRepository::read<IndexedString>([index](const IndexedStringRepository& repo) {
-            return stringFromItem(repo.itemFromIndex(index));
-        });
+        return LockedItemRepository::read<IndexedString>(
+            [index](const IndexedStringRepository& repo) {
+                return stringFromItem(repo.itemFromIndex(localIndex(index)));
+            },
+            shardForIndex(index));
     }
 }
 
@@ -355,9 +566,11 @@ int IndexedString::lengthFromIndex(uint index)
     } else if (isSingleCharIndex(index)) {
         return 1;
     } else {
-        return LockedItemRepository::read<IndexedString>([index](const IndexedStringRepository& repo) {
-            return repo.itemFromIndex(index)->length;
-        });
+        return LockedItemRepository::read<IndexedString>(
+            [index](const IndexedStringRepository& repo) {
+                return repo.itemFromIndex(localIndex(index))->length;
+            },
+            shardForIndex(index));
     }
 }
 
@@ -374,9 +587,11 @@ const char* IndexedString::c_str() const
         return reinterpret_cast<const char*>(&m_index) + offset;
     } else {
         const uint index = m_index;
-        return LockedItemRepository::read<IndexedString>([index](const IndexedStringRepository& repo) {
-            return c_strFromItem(repo.itemFromIndex(index));
-        });
+        return LockedItemRepository::read<IndexedString>(
+            [index](const IndexedStringRepository& repo) {
+                return c_strFromItem(repo.itemFromIndex(localIndex(index)));
+            },
+            shardForIndex(index));
     }
 }
 
@@ -388,9 +603,11 @@ QByteArray IndexedString::byteArray() const
         return QByteArray(1, indexToChar(m_index));
     } else {
         const uint index = m_index;
-        return LockedItemRepository::read<IndexedString>([index](const IndexedStringRepository& repo) {
-            return arrayFromItem(repo.itemFromIndex(index));
-        });
+        return LockedItemRepository::read<IndexedString>(
+            [index](const IndexedStringRepository& repo) {
+                return arrayFromItem(repo.itemFromIndex(localIndex(index)));
+            },
+            shardForIndex(index));
     }
 }
 
@@ -412,10 +629,7 @@ uint IndexedString::indexForString(const char* str, short unsigned length, uint
     } else if (length == 1) {
         return charToIndex(str[0]);
     } else {
-        const auto request = IndexedStringRepositoryItemRequest(str, hash ? hash : hashString(str, length), length);
-        return LockedItemRepository::write<IndexedString>([request](IndexedStringRepository& repo) {
-            return repo.index(request);
-        });
+        return internString(str, length, hash, false);
     }
 }
 
@@ -430,6 +644,35 @@ uint IndexedString::indexForUrl(const QUrl& url)
     return indexForString(urlToString(url));
 }
 
+IndexedStringInternCache::IndexedStringInternCache()
+{
+    auto*& cache = ThreadInternCache::current();
+    if (!cache) {
+        cache = new ThreadInternCache;
+    }
+    ++cache->depth;
+}
+
+IndexedStringInternCache::~IndexedStringInternCache()
+{
+    auto*& cache = ThreadInternCache::current();
+    Q_ASSERT(cache);
+    if (!--cache->depth) {
+        delete cache;
+        cache = nullptr;
+    }
+}
+
+IndexedStringInternCache::Statistics IndexedStringInternCache::statistics()
+{
+    Statistics ret;
+    ret.hits = internCacheHits.load(std::memory_order_relaxed);
+    ret.misses = internCacheMisses.load(std::memory_order_relaxed);
+    ret.batchedReferenceCountChanges = internCacheBatchedReferenceCountChanges.load(std::memory_order_relaxed);
+    ret.referenceCountFlushes = internCacheReferenceCountFlushes.load(std::memory_order_relaxed);
+    return ret;
+}
+
 QDebug operator<<(QDebug s, const IndexedString& string)
 {
     s.nospace() << string.str();
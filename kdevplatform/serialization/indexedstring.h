@@ -248,6 +248,43 @@ private:
     uint m_index = 0;
 };
 
+/**
+ * Puts a bounded cache in front of the IndexedString repository for the current thread, as long as
+ * an instance of this class exists on it.
+ *
+ * Parse jobs intern the same identifiers and paths over and over again. While the cache is enabled,
+ * such repeated lookups don't need to hash into and lock the repository. Reference count changes of
+ * disk-reference-counted strings are collected as well, and are only applied in batches.
+ *
+ * The collected reference count changes are applied at the latest when the outermost instance on
+ * a thread is destroyed. Thus an instance must not be alive while the repositories are stored,
+ * i.e. it should only exist while a language's parse lock is held.
+ *
+ * Instances can be nested, only the outermost one enables and flushes the cache.
+ */
+class KDEVPLATFORMSERIALIZATION_EXPORT IndexedStringInternCache
+{
+    Q_DISABLE_COPY_MOVE(IndexedStringInternCache)
+public:
+    IndexedStringInternCache();
+    ~IndexedStringInternCache();
+
+    struct Statistics
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        /// number of reference count changes that did not lock the repository
+        quint64 batchedReferenceCountChanges = 0;
+        /// number of times collected reference count changes were applied to the repository
+        quint64 referenceCountFlushes = 0;
+    };
+
+    /**
+     * @return the statistics summed up over all caches which have been disabled so far
+     */
+    static Statistics statistics();
+};
+
 // the following function would need to be exported in case you'd remove the inline keyword.
 inline size_t qHash(const KDevelop::IndexedString& str)
 {
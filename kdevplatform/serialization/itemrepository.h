@@ -17,7 +17,9 @@
 #include <KLocalizedString>
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <shared_mutex>
 #include <type_traits>
 
 #include "referencecounting.h"
@@ -151,6 +153,60 @@ void writeList(QIODevice* file, const QVector<T>& from)
 {
     writeValues(file, from.size(), from.data());
 }
+
+/**
+ * A pointer to a bucket, which may be loaded lazily by readers that only hold a shared lock
+ * on the repository while other readers look it up concurrently.
+ *
+ * Behaves like a plain pointer otherwise, so that the repository code can stay unchanged.
+ */
+template<typename Bucket>
+class AtomicBucketPointer
+{
+public:
+    AtomicBucketPointer() = default;
+    AtomicBucketPointer(const AtomicBucketPointer& other)
+        : m_bucket(other.load())
+    {
+    }
+    AtomicBucketPointer& operator=(const AtomicBucketPointer& other)
+    {
+        m_bucket.store(other.load(), std::memory_order_release);
+        return *this;
+    }
+    AtomicBucketPointer& operator=(Bucket* bucket)
+    {
+        m_bucket.store(bucket, std::memory_order_release);
+        return *this;
+    }
+
+    Bucket* load() const
+    {
+        return m_bucket.load(std::memory_order_acquire);
+    }
+    operator Bucket*() const
+    {
+        return load();
+    }
+    Bucket* operator->() const
+    {
+        return load();
+    }
+
+private:
+    std::atomic<Bucket*> m_bucket = nullptr;
+};
+
+/// Whether @p Mutex can be locked for shared access, e.g. std::shared_mutex
+template<typename Mutex, typename = void>
+struct IsSharedMutex : std::false_type
+{
+};
+
+template<typename Mutex>
+struct IsSharedMutex<Mutex, std::void_t<decltype(std::declval<Mutex&>().lock_shared())>> : std::true_type
+{
+};
 }
 /**
  * This file implements a generic bucket-based indexing repository, that can be used for example to index strings.
@@ -243,7 +299,7 @@ public:
 
             m_changed = true;
             m_dirty = false;
-            m_lastUsed = 0;
+            markUsed();
         }
     }
 
@@ -268,7 +324,7 @@ public:
         m_mappedData = m_data;
 
         m_changed = false;
-        m_lastUsed = 0;
+        markUsed();
         Q_ASSERT(fileMap.current() - fileMapData == DataSize - ItemRepositoryBucketSize);
     }
 
@@ -355,7 +411,7 @@ public:
     //Tries to find the index this item has in this bucket, or returns zero if the item isn't there yet.
     unsigned short findIndex(const ItemRequest& request) const
     {
-        m_lastUsed = 0;
+        markUsed();
 
         unsigned short localHash = request.hash() % ObjectMapSize;
         unsigned short index = m_objectMap[localHash];
@@ -376,7 +432,7 @@ public:
     //Created indices will never begin with 0xffff____, so you can use that index-range for own purposes.
     unsigned short index(const ItemRequest& request, unsigned int itemSize)
     {
-        m_lastUsed = 0;
+        markUsed();
 
         unsigned short localHash = request.hash() % ObjectMapSize;
         unsigned short index = m_objectMap[localHash];
@@ -548,7 +604,7 @@ public:
     {
         Q_ASSERT(modulo % ObjectMapSize == 0);
 
-        m_lastUsed = 0;
+        markUsed();
 
         uint hashMod = hash % modulo;
         unsigned short localHash = hash % ObjectMapSize;
@@ -613,7 +669,7 @@ public:
     {
         ifDebugLostSpace(Q_ASSERT(!lostSpace()); )
 
-        m_lastUsed = 0;
+        markUsed();
         prepareChange();
 
         unsigned int size = itemFromIndex(index)->itemSize();
@@ -703,7 +759,7 @@ public:
     ///@warning When using multi-threading, mutex() must be locked as long as you use the returned data
     inline const Item* itemFromIndex(unsigned short index) const
     {
-        m_lastUsed = 0;
+        markUsed();
         return reinterpret_cast<Item*>(m_data + index);
     }
 
@@ -752,7 +808,7 @@ public:
     template <class Visitor>
     bool visitAllItems(Visitor& visitor) const
     {
-        m_lastUsed = 0;
+        markUsed();
         for (uint a = 0; a < ObjectMapSize; ++a) {
             uint currentIndex = m_objectMap[a];
             while (currentIndex) {
@@ -802,13 +858,13 @@ public:
 
     unsigned short nextBucketForHash(uint hash) const
     {
-        m_lastUsed = 0;
+        markUsed();
         return m_nextBucketHash[hash % NextBucketHashSize];
     }
 
     void setNextBucketForHash(unsigned int hash, unsigned short bucket)
     {
-        m_lastUsed = 0;
+        markUsed();
         prepareChange();
         m_nextBucketHash[hash % NextBucketHashSize] = bucket;
     }
@@ -860,13 +916,22 @@ public:
 
     void tick() const
     {
-        ++m_lastUsed;
+        m_lastUsed.fetch_add(1, std::memory_order_relaxed);
     }
 
     //How many ticks ago the item was last used
     int lastUsed() const
     {
-        return m_lastUsed;
+        return m_lastUsed.load(std::memory_order_relaxed);
+    }
+
+    //Resets the tick counter. Can be called by concurrent readers, so only write when really needed,
+    //to not bounce the cache line between them.
+    void markUsed() const
+    {
+        if (m_lastUsed.load(std::memory_order_relaxed)) {
+            m_lastUsed.store(0, std::memory_order_relaxed);
+        }
     }
 
     //Whether this bucket was changed since it was last stored
@@ -1100,7 +1165,7 @@ private:
 
     bool m_dirty = false; //Whether the data was changed since the last finalCleanup
     bool m_changed  = false; //Whether this bucket was changed since it was last stored to disk
-    mutable int m_lastUsed = 0; //How many ticks ago this bucket was last accessed
+    mutable std::atomic<int> m_lastUsed{0}; //How many ticks ago this bucket was last accessed
 };
 
 ///This object needs to be kept alive as long as you change the contents of an item
@@ -1197,15 +1262,23 @@ struct ItemRepositoryStatistics {
  *                                 repository that does on-disk reference counting, like IndexedString,
  *                                 IndexedIdentifier, etc.
  * @tparam Mutex The mutex type to use internally. It has to be locked externally before accessing the item repository
- *               from multiple threads.
+ *               from multiple threads. When it is a shared mutex like std::shared_mutex, LockedItemRepository::read()
+ *               only locks it for shared access, so that multiple threads can look up items concurrently.
+ *               The const member functions are safe to be called concurrently under such a shared lock.
+ * @tparam maxBucketCount Upper limit for the bucket numbers, and thus for the created indices, which are
+ *                        (bucket number << 16) + index in bucket. Lower it to reserve the upper bits of the
+ *                        indices for own purposes, like splitting the data over multiple repositories.
  */
 
 template <class Item, class ItemRequest, bool markForReferenceCounting = true, typename Mutex = QMutex,
-          uint fixedItemSize = 0, unsigned int targetBucketHashSize = 524288 * 2>
+          uint fixedItemSize = 0, unsigned int targetBucketHashSize = 524288 * 2, int maxBucketCount = 0xfffe>
 class ItemRepository : public AbstractItemRepository
 {
     using MyBucket = Bucket<Item, ItemRequest, markForReferenceCounting, fixedItemSize>;
 
+    //We have reserved the last bucket index 0xffff for special purposes
+    static_assert(maxBucketCount > 0 && maxBucketCount <= 0xfffe);
+
     enum {
         //Must be a multiple of Bucket::ObjectMapSize, so Bucket::hasClashingItem can be computed
         //Must also be a multiple of Bucket::NextBucketHashSize, for the same reason.(Currently those are same)
@@ -1329,15 +1402,14 @@ public:
 
         //The item isn't in the repository yet, find a new bucket for it
         while (1) {
+            if (useBucket >= maxBucketCount) {
+                //the repository has overflown.
+                qWarning() << "Found no room for an item in" << m_repositoryName << "size of the item:" <<
+                    request.itemSize();
+                return 0;
+            }
             if (useBucket >= m_buckets.size()) {
-                if (m_buckets.size() >= 0xfffe) { //We have reserved the last bucket index 0xffff for special purposes
-                    //the repository has overflown.
-                    qWarning() << "Found no room for an item in" << m_repositoryName << "size of the item:" <<
-                        request.itemSize();
-                    return 0;
-                } else {
-                    allocateNextBuckets(ItemRepositoryBucketLinearGrowthFactor);
-                }
+                allocateNextBuckets(ItemRepositoryBucketLinearGrowthFactor);
             }
 
             if (!useBucket) {
@@ -1407,6 +1479,12 @@ public:
                     Q_ASSERT(needMonsterExtent);
                     const auto currentBucketIncrease = needMonsterExtent + 1;
                     Q_ASSERT(m_currentBucket);
+                    if (m_currentBucket + currentBucketIncrease >= maxBucketCount) {
+                        //the repository has overflown.
+                        qWarning() << "Found no room for a monster bucket in" << m_repositoryName
+                                   << "size of the item:" << request.itemSize();
+                        return 0;
+                    }
                     if (m_currentBucket + currentBucketIncrease >= m_buckets.size()) {
                         allocateNextBuckets(ItemRepositoryBucketLinearGrowthFactor + currentBucketIncrease);
                     }
@@ -1675,7 +1753,7 @@ public:
         Q_ASSERT(!m_currentBucket || m_currentBucket < m_buckets.size());
         ItemRepositoryStatistics ret;
         uint loadedBuckets = 0;
-        for (auto* bucket : m_buckets) {
+        for (const MyBucket* bucket : m_buckets) {
             if (bucket) {
                 ++loadedBuckets;
             }
@@ -1702,7 +1780,7 @@ public:
         ret.emptyBuckets = 0;
 
         uint loadedMonsterBuckets = 0;
-        for (auto* bucket : m_buckets) {
+        for (const MyBucket* bucket : m_buckets) {
             if (bucket && bucket->monsterBucketExtent()) {
                 loadedMonsterBuckets += bucket->monsterBucketExtent() + 1;
             }
@@ -1843,18 +1921,26 @@ private:
 
     ///Synchronizes the state on disk to the one in memory, and does some memory-management.
     ///Should be called on a regular basis. Can be called centrally from the global item repository registry.
+    ///Only the buckets changed since the last call are written. The files are not touched at all when nothing changed.
     void store() final
     {
         if (m_file) {
-            if (!m_file->open(QFile::ReadWrite) || !m_dynamicFile->open(QFile::ReadWrite)) {
-                qFatal("cannot re-open repository file for storing");
-                return;
-            }
+            bool filesOpen = false;
+            const auto openFiles = [this, &filesOpen] {
+                if (filesOpen) {
+                    return;
+                }
+                if (!m_file->open(QFile::ReadWrite) || !m_dynamicFile->open(QFile::ReadWrite)) {
+                    qFatal("cannot re-open repository file for storing");
+                }
+                filesOpen = true;
+            };
 
             for (int a = 0; a < m_buckets.size(); ++a) {
                 auto& bucket = m_buckets[a];
                 if (bucket) {
                     if (bucket->changed()) {
+                        openFiles();
                         storeBucket(a);
                     }
                     if (m_unloadingEnabled) {
@@ -1870,11 +1956,15 @@ private:
             }
 
             if (m_metaDataChanged) {
+                openFiles();
                 writeMetadata();
+                m_metaDataChanged = false;
+            }
+            if (filesOpen) {
+                //To protect us from inconsistency due to crashes. flush() is not enough. We need to close.
+                m_file->close();
+                m_dynamicFile->close();
             }
-            //To protect us from inconsistency due to crashes. flush() is not enough. We need to close.
-            m_file->close();
-            m_dynamicFile->close();
             Q_ASSERT(!m_file->isOpen());
             Q_ASSERT(!m_dynamicFile->isOpen());
         }
@@ -2030,13 +2120,16 @@ private:
             a += bucket->monsterBucketExtent(); // Skip buckets that are attached as tail to monster-buckets
         }
 
+        if (changed) {
+            m_metaDataChanged = true;
+        }
         return changed;
     }
 
     uint usedMemory() const
     {
         uint used = 0;
-        for (auto* bucket : m_buckets) {
+        for (const MyBucket* bucket : m_buckets) {
             if (bucket) {
                 used += bucket->usedMemory();
             }
@@ -2314,45 +2407,50 @@ private:
 
 #endif
 
-        auto& bucket = m_buckets[bucketNumber];
-        if (!bucket) {
-            bucket = new MyBucket();
+        // Readers holding only a shared lock on the repository may get here concurrently,
+        // so load the bucket completely before publishing it in m_buckets.
+        QMutexLocker lock(&m_bucketLoadingMutex);
 
-            bool doMMapLoading = ( bool )m_fileMap;
+        auto& bucketSlot = m_buckets[bucketNumber];
+        if (MyBucket* bucket = bucketSlot) {
+            return bucket;
+        }
 
-            uint offset = ((bucketNumber - 1) * MyBucket::DataSize);
-            if (m_file && offset < m_fileMapSize && doMMapLoading &&
-                *reinterpret_cast<uint*>(m_fileMap + offset) == 0) {
-//         qDebug() << "loading bucket mmap:" << bucketNumber;
-                bucket->initializeFromMap(reinterpret_cast<char*>(m_fileMap + offset));
-            } else if (m_file) {
-                //Either memory-mapping is disabled, or the item is not in the existing memory-map,
-                //so we have to load it the classical way.
-                bool res = m_file->open(QFile::ReadOnly);
-
-                if (offset + BucketStartOffset < m_file->size()) {
-                    VERIFY(res);
-                    offset += BucketStartOffset;
-                    m_file->seek(offset);
-                    int monsterBucketExtent;
-                    readValue(m_file, &monsterBucketExtent);
-                    m_file->seek(offset);
-                    ///FIXME: use the data here instead of copying it again in prepareChange
-                    QByteArray data = m_file->read((1 + monsterBucketExtent) * MyBucket::DataSize);
-                    bucket->initializeFromMap(data.data());
-                    bucket->prepareChange();
-                } else {
-                    bucket->initialize(0);
-                }
+        auto* bucket = new MyBucket();
 
-                m_file->close();
+        bool doMMapLoading = ( bool )m_fileMap;
+
+        uint offset = ((bucketNumber - 1) * MyBucket::DataSize);
+        if (m_file && offset < m_fileMapSize && doMMapLoading &&
+            *reinterpret_cast<uint*>(m_fileMap + offset) == 0) {
+//         qDebug() << "loading bucket mmap:" << bucketNumber;
+            bucket->initializeFromMap(reinterpret_cast<char*>(m_fileMap + offset));
+        } else if (m_file) {
+            //Either memory-mapping is disabled, or the item is not in the existing memory-map,
+            //so we have to load it the classical way.
+            bool res = m_file->open(QFile::ReadOnly);
+
+            if (offset + BucketStartOffset < m_file->size()) {
+                VERIFY(res);
+                offset += BucketStartOffset;
+                m_file->seek(offset);
+                int monsterBucketExtent;
+                readValue(m_file, &monsterBucketExtent);
+                m_file->seek(offset);
+                ///FIXME: use the data here instead of copying it again in prepareChange
+                QByteArray data = m_file->read((1 + monsterBucketExtent) * MyBucket::DataSize);
+                bucket->initializeFromMap(data.data());
+                bucket->prepareChange();
             } else {
                 bucket->initialize(0);
             }
+
+            m_file->close();
         } else {
             bucket->initialize(0);
         }
 
+        bucketSlot = bucket;
         return bucket;
     }
 
@@ -2465,8 +2563,10 @@ private:
 
     void allocateNextBuckets(int numNewBuckets)
     {
-        Q_ASSERT(numNewBuckets > 0);
         const auto oldSize = m_buckets.size();
+        // never create buckets that could not be addressed by an index
+        numNewBuckets = std::min(numNewBuckets, static_cast<int>(maxBucketCount - oldSize));
+        Q_ASSERT(numNewBuckets > 0);
         m_buckets.resize(oldSize + numNewBuckets);
         m_monsterBucketTailMarker.resize(m_buckets.size());
 
@@ -2508,7 +2608,9 @@ private:
     // this allows us to ensure we don't try to put an entry into such a bucket later on, which would corrupt data
     QVector<bool> m_monsterBucketTailMarker;
     //List of hash map buckets that actually hold the data of the item repository
-    mutable QVector<MyBucket*> m_buckets;
+    mutable QVector<ItemRepositoryUtils::AtomicBucketPointer<MyBucket>> m_buckets;
+    //Serializes the lazy loading of buckets by concurrent readers, see bucketForIndex()
+    mutable QMutex m_bucketLoadingMutex;
     uint m_statBucketHashClashes = 0;
     uint m_statItemCount = 0;
     //Maps hash-values modulo 1<<bucketHashSizeBits to the first bucket such a hash-value appears in
@@ -2533,20 +2635,27 @@ private:
 template<typename Context>
 class ItemRepositoryFor;
 
+/// Locks the repository returned by ItemRepositoryFor<Context>::repo(repoArgs...) while calling @p op with it.
 struct LockedItemRepository {
-    template<typename Context, typename Op>
-    static auto read(Op&& op)
+    template<typename Context, typename Op, typename... RepoArgs>
+    static auto read(Op&& op, RepoArgs... repoArgs)
     {
-        const auto& repo = ItemRepositoryFor<Context>::repo();
+        const auto& repo = ItemRepositoryFor<Context>::repo(repoArgs...);
 
-        QMutexLocker lock(repo.mutex());
-        return op(repo);
+        using Mutex = std::remove_pointer_t<decltype(repo.mutex())>;
+        if constexpr (ItemRepositoryUtils::IsSharedMutex<Mutex>::value) {
+            std::shared_lock<Mutex> lock(*repo.mutex());
+            return op(repo);
+        } else {
+            QMutexLocker lock(repo.mutex());
+            return op(repo);
+        }
     }
 
-    template<typename Context, typename Op>
-    static auto write(Op&& op)
+    template<typename Context, typename Op, typename... RepoArgs>
+    static auto write(Op&& op, RepoArgs... repoArgs)
     {
-        auto& repo = ItemRepositoryFor<Context>::repo();
+        auto& repo = ItemRepositoryFor<Context>::repo(repoArgs...);
 
         QMutexLocker lock(repo.mutex());
         return op(repo);
@@ -12,7 +12,9 @@
 #include <QDataStream>
 #include <QMutexLocker>
 #include <QRecursiveMutex>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <QtConcurrentMap>
 
 #include <KLocalizedString>
 
@@ -20,6 +22,7 @@
 
 #include "abstractitemrepository.h"
 #include "debug.h"
+#include "indexedstring.h"
 
 #include <mutex>
 #include <set>
@@ -301,10 +304,13 @@ void ItemRepositoryRegistry::store()
     Q_D(ItemRepositoryRegistry);
 
     QMutexLocker lock(&d->m_mutex);
-    for (auto* repository : std::as_const(d->m_repositories)) {
+    // The repositories are independent of each other, so write them in parallel.
+    // NOTE: the calling thread must not hold a repository lock, the worker threads would dead-lock on it.
+    QList<AbstractItemRepository*> repositories(d->m_repositories.cbegin(), d->m_repositories.cend());
+    QtConcurrent::blockingMap(repositories, [](AbstractItemRepository* repository) {
         std::scoped_lock repoLock(*repository);
         repository->store();
-    }
+    });
 
     QFile versionFile(d->m_path + QStringLiteral("/version_%1").arg(staticItemRepositoryVersion()));
     if (versionFile.open(QIODevice::WriteOnly)) {
@@ -314,9 +320,9 @@ void ItemRepositoryRegistry::store()
     }
 
     //Store all custom counter values
-    QFile f(d->m_path + QLatin1String("/Counters"));
+    //Write a new file and rename it when complete, as a truncated file would reset the counters
+    QSaveFile f(d->m_path + QLatin1String("/Counters"));
     if (f.open(QIODevice::WriteOnly)) {
-        f.resize(0);
         QDataStream stream(&f);
         for (QMap<QString, QAtomicInt*>::const_iterator it = d->m_customCounters.constBegin();
              it != d->m_customCounters.constEnd();
@@ -324,6 +330,9 @@ void ItemRepositoryRegistry::store()
             stream << it.key();
             stream << it.value()->fetchAndAddRelaxed(0);
         }
+        if (!f.commit()) {
+            qCWarning(SERIALIZATION) << "Could not write counter file" << f.errorString();
+        }
     } else {
         qCWarning(SERIALIZATION) << "Could not open counter file for writing";
     }
@@ -339,6 +348,11 @@ void ItemRepositoryRegistry::printAllStatistics() const
         qCDebug(SERIALIZATION) << "statistics in" << repository->repositoryName() << ":";
         qCDebug(SERIALIZATION) << repository->printStatistics();
     }
+
+    const auto internCache = IndexedStringInternCache::statistics();
+    qCDebug(SERIALIZATION) << "string intern cache: hits:" << internCache.hits << "misses:" << internCache.misses
+                           << "batched reference count changes:" << internCache.batchedReferenceCountChanges
+                           << "reference count flushes:" << internCache.referenceCountFlushes;
 }
 
 int ItemRepositoryRegistry::finalCleanup()
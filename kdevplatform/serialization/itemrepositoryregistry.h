@@ -57,7 +57,9 @@ public:
     QString path() const;
 
     /// Stores all repositories to disk, eventually unloading unused data to save memory.
+    /// The repositories are stored in parallel, each one only writes the data changed since it was last stored.
     /// @note Should be called on a regular basis.
+    /// @note The calling thread must not hold the lock of any repository.
     void store();
 
     /// Indicates that the application has been closed gracefully.
@@ -13,7 +13,10 @@
 #include <tests/testhelpers.h>
 
 #include <QTest>
+#include <QThread>
 
+#include <optional>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -45,6 +48,76 @@ void BenchIndexedString::bench_index()
     }
 }
 
+void BenchIndexedString::bench_index_parallel_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<bool>("sameStrings");
+
+    const int maxThreads = qMax(2, QThread::idealThreadCount());
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        QTest::addRow("distinct-%d", threads) << threads << false;
+        QTest::addRow("same-%d", threads) << threads << true;
+    }
+}
+
+void BenchIndexedString::bench_index_parallel()
+{
+    QFETCH(int, threads);
+    QFETCH(bool, sameStrings);
+
+    // like parse jobs, every thread either interns its own strings or all of them intern the same ones
+    const QVector<QString> data = generateData();
+    const auto intern = [&data, threads, sameStrings](int thread) {
+        const int step = sameStrings ? 1 : threads;
+        for (int i = sameStrings ? 0 : thread; i < data.size(); i += step) {
+            IndexedString idx(data[i]);
+            Q_UNUSED(idx);
+        }
+    };
+
+    QBENCHMARK {
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (int thread = 0; thread < threads; ++thread) {
+            workers.emplace_back(intern, thread);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+}
+
+void BenchIndexedString::bench_index_cached_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("repository") << false;
+    QTest::newRow("intern cache") << true;
+}
+
+void BenchIndexedString::bench_index_cached()
+{
+    QFETCH(bool, cached);
+
+    // parse jobs intern few distinct identifiers many times
+    QVector<QByteArray> data;
+    const auto identifiers = generateData();
+    for (int i = 0; i < 100000; ++i) {
+        data.append(identifiers[i % 500].toUtf8());
+    }
+
+    std::optional<IndexedStringInternCache> cache;
+    if (cached) {
+        cache.emplace();
+    }
+    QBENCHMARK {
+        for (const QByteArray& item : std::as_const(data)) {
+            IndexedString idx(item);
+            Q_UNUSED(idx);
+        }
+    }
+}
+
 static QVector<uint> setupTest()
 {
     const QVector<QString> data = generateData();
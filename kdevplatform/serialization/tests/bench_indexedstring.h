@@ -23,6 +23,10 @@ public:
 
 private Q_SLOTS:
     void bench_index();
+    void bench_index_parallel_data();
+    void bench_index_parallel();
+    void bench_index_cached_data();
+    void bench_index_cached();
     void bench_length();
     void bench_qstring();
     void bench_kurl();
@@ -7,14 +7,20 @@
 #include "bench_itemrepository.h"
 
 #include <serialization/itemrepository.h>
+#include <serialization/itemrepositoryregistry.h>
 #include <serialization/indexedstring.h>
 #include <serialization/referencecounting.h>
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
+#include <memory>
 #include <random>
+#include <shared_mutex>
+#include <thread>
 #include <vector>
 #include <QTest>
+#include <QThread>
 
 QTEST_GUILESS_MAIN(BenchItemRepository)
 
@@ -96,6 +102,7 @@ struct TestDataRepositoryItemRequest
 };
 
 using TestDataRepository = ItemRepository<TestData, TestDataRepositoryItemRequest, false>;
+using SharedTestDataRepository = ItemRepository<TestData, TestDataRepositoryItemRequest, false, std::shared_mutex>;
 
 static QVector<QString> generateData()
 {
@@ -109,7 +116,8 @@ static QVector<QString> generateData()
     return data;
 }
 
-static QVector<uint> insertData(const QVector<QString>& data, TestDataRepository& repo)
+template<typename Repository>
+static QVector<uint> insertData(const QVector<QString>& data, Repository& repo)
 {
     QVector<uint> indices;
     indices.reserve(data.size());
@@ -205,6 +213,125 @@ void BenchItemRepository::lookupValue()
     }
 }
 
+template<typename Repository>
+static int lookupParallel(const Repository& repo, const QVector<QString>& data, int threadCount)
+{
+    std::atomic<int> found = 0;
+    const auto lookup = [&](int thread) {
+        using Mutex = std::remove_pointer_t<decltype(repo.mutex())>;
+        int foundInThread = 0;
+        for (int i = thread; i < data.size(); i += threadCount) {
+            const QByteArray byteArray = data[i].toUtf8();
+            const TestDataRepositoryItemRequest request(byteArray.constData(), byteArray.length());
+
+            if constexpr (ItemRepositoryUtils::IsSharedMutex<Mutex>::value) {
+                std::shared_lock<Mutex> lock(*repo.mutex());
+                foundInThread += repo.itemFromIndex(repo.findIndex(request))->length == request.m_length;
+            } else {
+                QMutexLocker lock(repo.mutex());
+                foundInThread += repo.itemFromIndex(repo.findIndex(request))->length == request.m_length;
+            }
+        }
+        found += foundInThread;
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (int thread = 0; thread < threadCount; ++thread) {
+        threads.emplace_back(lookup, thread);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return found;
+}
+
+void BenchItemRepository::lookupParallel_data()
+{
+    QTest::addColumn<bool>("sharedMutex");
+    QTest::addColumn<int>("threads");
+
+    const int maxThreads = qMax(2, QThread::idealThreadCount());
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        QTest::addRow("QMutex-%d", threads) << false << threads;
+        QTest::addRow("shared_mutex-%d", threads) << true << threads;
+    }
+}
+
+void BenchItemRepository::lookupParallel()
+{
+    QFETCH(bool, sharedMutex);
+    QFETCH(int, threads);
+
+    const QVector<QString> data = generateData();
+    if (sharedMutex) {
+        std::shared_mutex mutex;
+        SharedTestDataRepository repo("TestDataRepositoryLookupParallelShared", &mutex);
+        insertData(data, repo);
+        // lookups of buckets that were stored before are lazily loaded from disk by the readers
+        repo.store();
+        QBENCHMARK {
+            QCOMPARE(::lookupParallel(repo, data, threads), static_cast<int>(data.size()));
+        }
+    } else {
+        QMutex mutex;
+        TestDataRepository repo("TestDataRepositoryLookupParallel", &mutex);
+        insertData(data, repo);
+        repo.store();
+        QBENCHMARK {
+            QCOMPARE(::lookupParallel(repo, data, threads), static_cast<int>(data.size()));
+        }
+    }
+}
+
+void BenchItemRepository::storeRegistry_data()
+{
+    QTest::addColumn<int>("repositoryCount");
+    QTest::addColumn<bool>("changed");
+
+    for (int repositoryCount : {1, 4, 16}) {
+        QTest::addRow("%d-changed", repositoryCount) << repositoryCount << true;
+        QTest::addRow("%d-unchanged", repositoryCount) << repositoryCount << false;
+    }
+}
+
+void BenchItemRepository::storeRegistry()
+{
+    QFETCH(int, repositoryCount);
+    QFETCH(bool, changed);
+
+    struct Repository
+    {
+        explicit Repository(int number)
+            : repo(QStringLiteral("TestDataRepositoryStore%1").arg(number), &mutex)
+        {
+        }
+
+        QMutex mutex;
+        TestDataRepository repo;
+    };
+
+    const QVector<QString> data = generateData();
+    std::vector<std::unique_ptr<Repository>> repositories;
+    for (int i = 0; i < repositoryCount; ++i) {
+        repositories.push_back(std::make_unique<Repository>(i));
+        QMutexLocker lock(&repositories.back()->mutex);
+        insertData(data, repositories.back()->repo);
+    }
+    if (!changed) {
+        globalItemRepositoryRegistry().store();
+    }
+
+    QBENCHMARK_ONCE {
+        globalItemRepositoryRegistry().store();
+    }
+
+    for (const auto& repository : repositories) {
+        QMutexLocker lock(&repository->mutex);
+        QCOMPARE(repository->repo.statistics().totalItems, uint(data.size()));
+    }
+}
+
 void BenchItemRepository::shouldDoReferenceCounting_data()
 {
     QTest::addColumn<bool>("enableReferenceCounting");
@@ -20,6 +20,10 @@ private Q_SLOTS:
     void removeDisk();
     void lookupKey();
     void lookupValue();
+    void lookupParallel_data();
+    void lookupParallel();
+    void storeRegistry_data();
+    void storeRegistry();
 
     void shouldDoReferenceCounting_data();
     void shouldDoReferenceCounting();
@@ -178,4 +178,36 @@ void TestIndexedString::testCString()
     QVERIFY(str.isEmpty());
 }
 
+void TestIndexedString::testInternCache()
+{
+    const QString text = QStringLiteral("cached text");
+    const uint uncachedIndex = IndexedString::indexForString(text);
+
+    const auto statsBefore = IndexedStringInternCache::statistics();
+    {
+        const IndexedStringInternCache cache;
+        {
+            const IndexedStringInternCache nestedCache;
+            QCOMPARE(IndexedString(text).index(), uncachedIndex);
+        }
+        QCOMPARE(IndexedString::indexForString(text), uncachedIndex);
+
+        // batched reference count changes must not disturb the strings
+        std::byte indexedStringData[sizeof(IndexedString)];
+        const DUChainReferenceCountingEnabler rcEnabler(indexedStringData, sizeof(IndexedString));
+        IndexedString* const refCounted = new (indexedStringData) IndexedString(text);
+        QCOMPARE(refCounted->index(), uncachedIndex);
+        *refCounted = IndexedString(QStringLiteral("other text"));
+        QCOMPARE(refCounted->str(), QStringLiteral("other text"));
+        refCounted->~IndexedString();
+
+        QCOMPARE(IndexedString(text).str(), text);
+    }
+    const auto statsAfter = IndexedStringInternCache::statistics();
+
+    QVERIFY(statsAfter.hits >= statsBefore.hits + 3);
+    QVERIFY(statsAfter.misses > statsBefore.misses);
+    QVERIFY(statsAfter.batchedReferenceCountChanges > statsBefore.batchedReferenceCountChanges);
+}
+
 #include "moc_test_indexedstring.cpp"
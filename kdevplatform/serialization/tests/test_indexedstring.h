@@ -26,6 +26,8 @@ private Q_SLOTS:
     void testSwap_data();
 
     void testCString();
+
+    void testInternCache();
 };
 
 #endif // TESTINDEXEDSTRING_H
@@ -30,6 +30,41 @@ void addDiagnostics(ProblemStoreNode *node, const QVector<IProblem::Ptr> &diagno
     }
 }
 
+/// Tells if the problem of @p node is located in @p document
+bool isLocatedIn(const ProblemStoreNode* node, const IndexedString& document)
+{
+    return node->problem()->finalLocation().document == document;
+}
+
+/// Appends @p child to @p parent. If @p store is set, the new row is announced with its signals
+void appendChild(ProblemStoreNode* parent, ProblemStoreNode* child, ProblemStore* store)
+{
+    if (!store) {
+        parent->addChild(child);
+        return;
+    }
+
+    const int row = parent->count();
+    emit store->beginInsertNodes(parent, row, row);
+    parent->addChild(child);
+    emit store->endInsertNodes();
+}
+
+/// Removes the children of @p parent for which @p predicate returns true,
+/// announcing the removed rows with the signals of @p store
+template<typename Predicate>
+void removeChildren(ProblemStoreNode* parent, Predicate predicate, ProblemStore* store)
+{
+    parent->removeChildren(
+        predicate,
+        [parent, store](int first, int last) {
+            emit store->beginRemoveNodes(parent, first, last);
+        },
+        [store] {
+            emit store->endRemoveNodes();
+        });
+}
+
 /**
  * @brief Base class for grouping strategy classes
  *
@@ -47,8 +82,16 @@ public:
     virtual ~GroupingStrategy(){
     }
 
-    /// Add a problem to the appropriate group
-    virtual void addProblem(const IProblem::Ptr &problem) = 0;
+    /// Add a problem to the appropriate group. If @p store is set, the new rows are announced with its signals
+    virtual void addProblem(const IProblem::Ptr &problem, ProblemStore* store) = 0;
+
+    /// Remove the problems located in the specified document, announcing the removed rows with the signals of @p store
+    virtual void removeProblems(const IndexedString& document, ProblemStore* store)
+    {
+        removeChildren(m_groupedRootNode.data(), [&document](const ProblemStoreNode* node) {
+            return isLocatedIn(node, document);
+        }, store);
+    }
 
     /// Find the specified node
     const ProblemStoreNode* findNode(int row, ProblemStoreNode *parent = nullptr) const
@@ -90,11 +133,11 @@ public:
     {
     }
 
-    void addProblem(const IProblem::Ptr &problem) override
+    void addProblem(const IProblem::Ptr &problem, ProblemStore* store) override
     {
         auto *node = new ProblemNode(m_groupedRootNode.data(), problem);
         addDiagnostics(node, problem->diagnostics());
-        m_groupedRootNode->addChild(node);
+        appendChild(m_groupedRootNode.data(), node, store);
 
     }
 
@@ -111,28 +154,45 @@ public:
     {
     }
 
-    void addProblem(const IProblem::Ptr &problem) override
+    void addProblem(const IProblem::Ptr &problem, ProblemStore* store) override
     {
-        QString path = problem->finalLocation().document.str();
+        const IndexedString& document = problem->finalLocation().document;
 
-        /// See if we already have this path
-        const auto childrenNodes = m_groupedRootNode->children();
-        auto it = std::find_if(childrenNodes.begin(), childrenNodes.end(), [&](ProblemStoreNode* node) {
-            return (node->label() == path);
-        });
-        ProblemStoreNode* parent = (it != childrenNodes.end()) ? *it : nullptr;
-
-        /// If not add it!
+        /// See if we already have this path, if not add it!
+        ProblemStoreNode*& parent = m_pathNodes[document];
         if (parent == nullptr) {
-            parent = new LabelNode(m_groupedRootNode.data(), path);
-            m_groupedRootNode->addChild(parent);
+            parent = new LabelNode(m_groupedRootNode.data(), document.str());
+            appendChild(m_groupedRootNode.data(), parent, store);
         }
 
         auto *node = new ProblemNode(parent, problem);
         addDiagnostics(node, problem->diagnostics());
-        parent->addChild(node);
+        appendChild(parent, node, store);
+    }
+
+    void removeProblems(const IndexedString& document, ProblemStore* store) override
+    {
+        /// All problems of the document are in its path node, so just drop that one
+        const auto it = m_pathNodes.constFind(document);
+        if (it == m_pathNodes.cend()) {
+            return;
+        }
+        const ProblemStoreNode* const pathNode = *it;
+        m_pathNodes.erase(it);
+        removeChildren(m_groupedRootNode.data(), [pathNode](const ProblemStoreNode* node) {
+            return node == pathNode;
+        }, store);
     }
 
+    void clear() override
+    {
+        GroupingStrategy::clear();
+        m_pathNodes.clear();
+    }
+
+private:
+    /// The path label nodes, by the document they stand for
+    QHash<IndexedString, ProblemStoreNode*> m_pathNodes;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -157,7 +217,7 @@ public:
         m_groupedRootNode->addChild(new LabelNode(m_groupedRootNode.data(), i18n("Hint")));
     }
 
-    void addProblem(const IProblem::Ptr &problem) override
+    void addProblem(const IProblem::Ptr &problem, ProblemStore* store) override
     {
         ProblemStoreNode *parent = nullptr;
 
@@ -170,7 +230,17 @@ public:
 
         auto *node = new ProblemNode(m_groupedRootNode.data(), problem);
         addDiagnostics(node, problem->diagnostics());
-        parent->addChild(node);
+        appendChild(parent, node, store);
+    }
+
+    void removeProblems(const IndexedString& document, ProblemStore* store) override
+    {
+        const auto groups = m_groupedRootNode->children();
+        for (ProblemStoreNode* group : groups) {
+            removeChildren(group, [&document](const ProblemStoreNode* node) {
+                return isLocatedIn(node, document);
+            }, store);
+        }
     }
 
     void clear() override
@@ -223,7 +293,7 @@ void FilteredProblemStore::addProblem(const IProblem::Ptr &problem)
     ProblemStore::addProblem(problem);
 
     if (d->match(problem))
-        d->m_strategy->addProblem(problem);
+        d->m_strategy->addProblem(problem, nullptr);
 }
 
 const ProblemStoreNode* FilteredProblemStore::findNode(int row, ProblemStoreNode *parent) const
@@ -260,13 +330,39 @@ void FilteredProblemStore::rebuild()
     for (ProblemStoreNode* node : childrenNodes) {
         IProblem::Ptr problem = node->problem();
         if (d->match(problem)) {
-            d->m_strategy->addProblem(problem);
+            d->m_strategy->addProblem(problem, nullptr);
         }
     }
 
     emit endRebuild();
 }
 
+void FilteredProblemStore::rebuildDocument(const IndexedString& document, const QVector<IProblem::Ptr>& oldProblems)
+{
+    Q_D(FilteredProblemStore);
+
+    /// Only the filtered problem tree is shown, so the changes to the list of all problems are not announced
+    {
+        QSignalBlocker blocker(this);
+        ProblemStore::rebuildDocument(document, oldProblems);
+    }
+
+    /// Only the filtered problems are in the tree, so there's nothing to remove if none of the old ones matched
+    const bool anyOldProblemShown = std::any_of(oldProblems.begin(), oldProblems.end(), [d](const IProblem::Ptr& problem) {
+        return d->match(problem);
+    });
+    if (anyOldProblemShown) {
+        d->m_strategy->removeProblems(document, this);
+    }
+
+    const auto newProblems = problems(document);
+    for (const IProblem::Ptr& problem : newProblems) {
+        if (d->match(problem)) {
+            d->m_strategy->addProblem(problem, this);
+        }
+    }
+}
+
 void FilteredProblemStore::setGrouping(int grouping)
 {
     Q_D(FilteredProblemStore);
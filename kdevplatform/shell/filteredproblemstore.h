@@ -89,6 +89,10 @@ public:
     /// Tells which grouping strategy is currently in use
     int grouping() const;
 
+protected:
+    /// Rebuilds only the part of the filtered problem tree that belongs to the document
+    void rebuildDocument(const IndexedString& document, const QVector<IProblem::Ptr>& oldProblems) override;
+
 private:
     friend class FilteredProblemStorePrivate;
     const QScopedPointer<class FilteredProblemStorePrivate> d_ptr;
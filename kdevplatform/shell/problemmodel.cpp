@@ -88,6 +88,20 @@ ProblemModel::ProblemModel(QObject * parent, ProblemStore *store)
 
     connect(d->m_problems.data(), &ProblemStore::beginRebuild, this, &ProblemModel::beginResetModel);
     connect(d->m_problems.data(), &ProblemStore::endRebuild, this, &ProblemModel::endResetModel);
+    connect(d->m_problems.data(), &ProblemStore::beginInsertNodes, this,
+            [this](ProblemStoreNode* parent, int first, int last) {
+                beginInsertRows(indexForNode(parent), first, last);
+            });
+    connect(d->m_problems.data(), &ProblemStore::endInsertNodes, this, [this] {
+        endInsertRows();
+    });
+    connect(d->m_problems.data(), &ProblemStore::beginRemoveNodes, this,
+            [this](ProblemStoreNode* parent, int first, int last) {
+                beginRemoveRows(indexForNode(parent), first, last);
+            });
+    connect(d->m_problems.data(), &ProblemStore::endRemoveNodes, this, [this] {
+        endRemoveRows();
+    });
 
     connect(d->m_problems.data(), &ProblemStore::problemsChanged, this, &ProblemModel::problemsChanged);
 }
@@ -185,13 +199,17 @@ QModelIndex ProblemModel::parent(const QModelIndex& index) const
         return {};
     }
 
-    ProblemStoreNode *parent = node->parent();
-    if (!parent || parent->isRoot()) {
+    return indexForNode(node->parent());
+}
+
+QModelIndex ProblemModel::indexForNode(ProblemStoreNode* node) const
+{
+    if (!node || node->isRoot()) {
         return {};
     }
 
-    int idx = parent->index();
-    return createIndex(idx, 0, parent);
+    int idx = node->index();
+    return createIndex(idx, 0, node);
 }
 
 QModelIndex ProblemModel::index(int row, int column, const QModelIndex& parent) const
@@ -23,6 +23,7 @@ namespace KDevelop {
 class IDocument;
 class IndexedString;
 class ProblemStore;
+class ProblemStoreNode;
 class ProblemModelPrivate;
 
 /**
@@ -224,6 +225,9 @@ protected:
     void endResetModel();
 
 private:
+    /// @return the index of @p node, or an invalid index for the root node of the store
+    QModelIndex indexForNode(ProblemStoreNode* node) const;
+
     const QScopedPointer<class ProblemModelPrivate> d_ptr;
     Q_DECLARE_PRIVATE(ProblemModel)
 };
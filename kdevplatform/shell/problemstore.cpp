@@ -38,8 +38,13 @@ public:
     /// Path for the DocumentsInPath scope
     QString m_pathForDocumentsInPathScope;
 
-    /// All stored problems
-    QVector<KDevelop::IProblem::Ptr> m_allProblems;
+    /// All stored problems, by the document they are located in
+    QHash<KDevelop::IndexedString, QVector<KDevelop::IProblem::Ptr>> m_problemsByDocument;
+
+    void addToIndex(const IProblem::Ptr& problem)
+    {
+        m_problemsByDocument[problem->finalLocation().document].append(problem);
+    }
 };
 
 
@@ -67,7 +72,7 @@ void ProblemStore::addProblem(const IProblem::Ptr &problem)
     node->setProblem(problem);
     d->m_rootNode->addChild(node);
 
-    d->m_allProblems += problem;
+    d->addToIndex(problem);
     emit problemsChanged();
 }
 
@@ -75,7 +80,12 @@ void ProblemStore::setProblems(const QVector<IProblem::Ptr> &problems)
 {
     Q_D(ProblemStore);
 
-    int oldSize = d->m_allProblems.size();
+    const auto& oldNodes = d->m_rootNode->children();
+    const bool changed = oldNodes.size() != problems.size()
+        || !std::equal(oldNodes.begin(), oldNodes.end(), problems.begin(),
+                       [](const ProblemStoreNode* node, const IProblem::Ptr& problem) {
+                           return node->problem() == problem;
+                       });
 
     // set signals block to prevent problemsChanged() emitting during clean
     {
@@ -85,28 +95,49 @@ void ProblemStore::setProblems(const QVector<IProblem::Ptr> &problems)
 
     for (const IProblem::Ptr& problem : problems) {
         d->m_rootNode->addChild(new ProblemNode(d->m_rootNode, problem));
+        d->addToIndex(problem);
     }
 
     rebuild();
 
-    if (d->m_allProblems.size() != oldSize || d->m_allProblems != problems) {
-        d->m_allProblems = problems;
+    if (changed) {
         emit problemsChanged();
     }
 }
 
-QVector<IProblem::Ptr> ProblemStore::problems(const KDevelop::IndexedString& document) const
+void ProblemStore::replaceProblems(const IndexedString& document, const QVector<IProblem::Ptr>& problems)
 {
-    Q_D(const ProblemStore);
+    Q_D(ProblemStore);
 
-    QVector<IProblem::Ptr> documentProblems;
+    auto it = d->m_problemsByDocument.find(document);
+    const auto oldProblems = it == d->m_problemsByDocument.end() ? QVector<IProblem::Ptr>{} : *it;
+    if (oldProblems == problems) {
+        return;
+    }
 
-    for (auto& problem : std::as_const(d->m_allProblems)) {
-        if (problem->finalLocation().document == document)
-            documentProblems += problem;
+    if (!oldProblems.isEmpty()) {
+        d->m_problemsByDocument.erase(it);
     }
+    for (const IProblem::Ptr& problem : problems) {
+        Q_ASSERT(problem->finalLocation().document == document);
+        d->addToIndex(problem);
+    }
+
+    rebuildDocument(document, oldProblems);
+
+    emit problemsChanged();
+}
+
+void ProblemStore::removeProblems(const IndexedString& document)
+{
+    replaceProblems(document, {});
+}
 
-    return documentProblems;
+QVector<IProblem::Ptr> ProblemStore::problems(const KDevelop::IndexedString& document) const
+{
+    Q_D(const ProblemStore);
+
+    return d->m_problemsByDocument.value(document);
 }
 
 const ProblemStoreNode* ProblemStore::findNode(int row, ProblemStoreNode *parent) const
@@ -133,8 +164,8 @@ void ProblemStore::clear()
 
     d->m_rootNode->clear();
 
-    if (!d->m_allProblems.isEmpty()) {
-        d->m_allProblems.clear();
+    if (!d->m_problemsByDocument.isEmpty()) {
+        d->m_problemsByDocument.clear();
         emit problemsChanged();
     }
 }
@@ -143,6 +174,35 @@ void ProblemStore::rebuild()
 {
 }
 
+void ProblemStore::rebuildDocument(const IndexedString& document, const QVector<IProblem::Ptr>& oldProblems)
+{
+    Q_D(ProblemStore);
+
+    ProblemStoreNode* const root = d->m_rootNode;
+    if (!oldProblems.isEmpty()) {
+        root->removeChildren(
+            [&document](const ProblemStoreNode* node) {
+                return node->problem()->finalLocation().document == document;
+            },
+            [this, root](int first, int last) {
+                emit beginRemoveNodes(root, first, last);
+            },
+            [this] {
+                emit endRemoveNodes();
+            });
+    }
+
+    const auto newProblems = problems(document);
+    if (!newProblems.isEmpty()) {
+        const int first = root->count();
+        emit beginInsertNodes(root, first, first + newProblems.size() - 1);
+        for (const IProblem::Ptr& problem : newProblems) {
+            root->addChild(new ProblemNode(root, problem));
+        }
+        emit endInsertNodes();
+    }
+}
+
 void ProblemStore::setSeverity(int severity)
 {
     switch (severity)
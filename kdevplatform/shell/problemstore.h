@@ -68,6 +68,18 @@ public:
     /// Clears the current problems, and adds new ones from a list
     virtual void setProblems(const QVector<IProblem::Ptr> &problems);
 
+    /**
+     * Replaces the problems located in @p document with @p problems, leaving the problems of other documents alone.
+     * Only the part of the problem list that belongs to @p document is rebuilt, and the changed rows are announced
+     * with beginRemoveNodes() and beginInsertNodes() instead of beginRebuild().
+     *
+     * @p problems are expected to be located in @p document.
+     */
+    void replaceProblems(const KDevelop::IndexedString& document, const QVector<IProblem::Ptr>& problems);
+
+    /// Removes the problems located in @p document
+    void removeProblems(const KDevelop::IndexedString& document);
+
     /// Retrieve problems for selected document
     QVector<IProblem::Ptr> problems(const KDevelop::IndexedString& document) const;
 
@@ -138,6 +150,18 @@ Q_SIGNALS:
     /// Emitted once the problemlist has been rebuilt
     void endRebuild();
 
+    /// Emitted before the children @p first to @p last of @p parent are inserted by replaceProblems()
+    void beginInsertNodes(KDevelop::ProblemStoreNode* parent, int first, int last);
+
+    /// Emitted once the children announced by beginInsertNodes() have been inserted
+    void endInsertNodes();
+
+    /// Emitted before the children @p first to @p last of @p parent are removed by replaceProblems()
+    void beginRemoveNodes(KDevelop::ProblemStoreNode* parent, int first, int last);
+
+    /// Emitted once the children announced by beginRemoveNodes() have been removed
+    void endRemoveNodes();
+
 private Q_SLOTS:
     /// Triggered when the watched document set changes. E.g.:document closed, new one added, etc
     virtual void onDocumentSetChanged();
@@ -145,6 +169,15 @@ private Q_SLOTS:
 protected:
     ProblemStoreNode* rootNode() const;
 
+    /**
+     * Updates the problems list after the problems located in @p document have been replaced.
+     * The base class replaces the problem nodes of @p document. Changed rows must be announced
+     * with beginRemoveNodes() and beginInsertNodes().
+     *
+     * @param oldProblems the problems that were located in @p document before
+     */
+    virtual void rebuildDocument(const KDevelop::IndexedString& document, const QVector<IProblem::Ptr>& oldProblems);
+
 private:
     const QScopedPointer<class ProblemStorePrivate> d_ptr;
     Q_DECLARE_PRIVATE(ProblemStore)
@@ -11,6 +11,8 @@
 #include <interfaces/iproblem.h>
 #include <shell/shellexport.h>
 
+#include <algorithm>
+
 namespace KDevelop
 {
 
@@ -104,6 +106,49 @@ public:
         child->setParent(this);
     }
 
+    /// Removes and deletes the children nodes for which @p predicate returns true
+    template<typename Predicate>
+    void removeChildren(Predicate predicate)
+    {
+        const auto it = std::remove_if(m_children.begin(), m_children.end(), [&predicate](ProblemStoreNode* child) {
+            if (!predicate(child)) {
+                return false;
+            }
+            delete child;
+            return true;
+        });
+        m_children.erase(it, m_children.end());
+    }
+
+    /**
+     * Removes and deletes the children nodes for which @p predicate returns true, one range of adjacent rows at a time.
+     *
+     * @p aboutToRemove is called with the first and the last row of each range before the range is removed,
+     * and @p removed afterwards. The ranges are removed from the last one to the first one.
+     */
+    template<typename Predicate, typename AboutToRemove, typename Removed>
+    void removeChildren(Predicate predicate, AboutToRemove aboutToRemove, Removed removed)
+    {
+        for (int last = m_children.size() - 1; last >= 0; --last) {
+            if (!predicate(m_children[last])) {
+                continue;
+            }
+            int first = last;
+            while (first > 0 && predicate(m_children[first - 1])) {
+                --first;
+            }
+
+            aboutToRemove(first, last);
+            const auto begin = m_children.begin() + first;
+            const auto end = m_children.begin() + last + 1;
+            qDeleteAll(begin, end);
+            m_children.erase(begin, end);
+            removed();
+
+            last = first;
+        }
+    }
+
     /// Returns the label of this node, if there's one
     virtual QString label() const{
         return QString();
@@ -0,0 +1,144 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+#include <shell/filteredproblemstore.h>
+#include <shell/problem.h>
+#include <shell/problemconstants.h>
+#include <language/editor/documentrange.h>
+
+#include <tests/testcore.h>
+#include <tests/autotestshell.h>
+
+using namespace KDevelop;
+
+namespace
+{
+const int DocumentCount = 1000;
+const int ProblemsPerDocument = 100;
+
+IndexedString documentPath(int document)
+{
+    return IndexedString(QStringLiteral("/bench/problemstore/file%1.cpp").arg(document));
+}
+
+QVector<IProblem::Ptr> generateProblems(int document, const QString& description)
+{
+    static const IProblem::Severity severities[] = {IProblem::Error, IProblem::Warning, IProblem::Hint};
+
+    QVector<IProblem::Ptr> problems;
+    problems.reserve(ProblemsPerDocument);
+    DocumentRange range;
+    range.document = documentPath(document);
+    for (int i = 0; i < ProblemsPerDocument; ++i) {
+        IProblem::Ptr problem(new DetectedProblem());
+        problem->setDescription(description);
+        problem->setSeverity(severities[i % 3]);
+        range.setBothLines(i);
+        problem->setFinalLocation(range);
+        problems.append(problem);
+    }
+    return problems;
+}
+}
+
+/// Updates the problems of one file among 100k problems in a FilteredProblemStore
+class BenchProblemStore : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchSetAllProblems_data();
+    void benchSetAllProblems();
+    void benchReplaceDocumentProblems_data();
+    void benchReplaceDocumentProblems();
+
+private:
+    void groupingData();
+
+    QVector<IProblem::Ptr> m_allProblems;
+    QVector<IProblem::Ptr> m_updatedProblems[2];
+};
+
+void BenchProblemStore::initTestCase()
+{
+    AutoTestShell::init();
+    TestCore::initialize(Core::NoUi);
+
+    m_allProblems.reserve(DocumentCount * ProblemsPerDocument);
+    for (int document = 0; document < DocumentCount; ++document) {
+        m_allProblems += generateProblems(document, QStringLiteral("PROBLEM"));
+    }
+    m_updatedProblems[0] = generateProblems(DocumentCount / 2, QStringLiteral("UPDATED PROBLEM"));
+    m_updatedProblems[1] = generateProblems(DocumentCount / 2, QStringLiteral("PROBLEM"));
+}
+
+void BenchProblemStore::cleanupTestCase()
+{
+    TestCore::shutdown();
+}
+
+void BenchProblemStore::groupingData()
+{
+    QTest::addColumn<int>("grouping");
+
+    QTest::newRow("no grouping") << int(NoGrouping);
+    QTest::newRow("path grouping") << int(PathGrouping);
+    QTest::newRow("severity grouping") << int(SeverityGrouping);
+}
+
+void BenchProblemStore::benchSetAllProblems_data()
+{
+    groupingData();
+}
+
+void BenchProblemStore::benchSetAllProblems()
+{
+    QFETCH(int, grouping);
+
+    FilteredProblemStore store;
+    store.setGrouping(grouping);
+    store.setProblems(m_allProblems);
+
+    // how the problems of one file used to be updated: set all problems again, with the updated ones
+    const int offset = DocumentCount / 2 * ProblemsPerDocument;
+    int round = 0;
+    QBENCHMARK {
+        auto problems = m_allProblems;
+        std::copy(m_updatedProblems[round].cbegin(), m_updatedProblems[round].cend(), problems.begin() + offset);
+        store.setProblems(problems);
+        round = 1 - round;
+    }
+    QVERIFY(store.count() > 0);
+}
+
+void BenchProblemStore::benchReplaceDocumentProblems_data()
+{
+    groupingData();
+}
+
+void BenchProblemStore::benchReplaceDocumentProblems()
+{
+    QFETCH(int, grouping);
+
+    FilteredProblemStore store;
+    store.setGrouping(grouping);
+    store.setProblems(m_allProblems);
+
+    const auto document = documentPath(DocumentCount / 2);
+    int round = 0;
+    QBENCHMARK {
+        store.replaceProblems(document, m_updatedProblems[round]);
+        round = 1 - round;
+    }
+    QCOMPARE(store.problems(document).size(), ProblemsPerDocument);
+}
+
+QTEST_MAIN(BenchProblemStore)
+
+#include "bench_problemstore.moc"
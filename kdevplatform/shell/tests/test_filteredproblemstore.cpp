@@ -46,6 +46,9 @@ private Q_SLOTS:
     void testPathGrouping();
     void testSeverityGrouping();
 
+    void testReplaceProblems_data();
+    void testReplaceProblems();
+
 private:
     // Severity grouping testing
     bool checkCounts(int error, int warning, int hint);
@@ -585,6 +588,94 @@ bool TestFilteredProblemStore::checkNodeLabels()
     return true;
 }
 
+/// Collects the descriptions of the problems in the tree, group by group
+QStringList problemDescriptions(const ProblemStore& store)
+{
+    QStringList descriptions;
+    for (int i = 0; i < store.count(); ++i) {
+        const ProblemStoreNode* node = store.findNode(i);
+        if (node->problem()) {
+            descriptions << node->problem()->description();
+            continue;
+        }
+        for (const ProblemStoreNode* child : node->children()) {
+            descriptions << child->problem()->description();
+        }
+    }
+    return descriptions;
+}
+
+void TestFilteredProblemStore::testReplaceProblems_data()
+{
+    QTest::addColumn<int>("grouping");
+    QTest::addColumn<QStringList>("afterReplace");
+    QTest::addColumn<QStringList>("afterRemove");
+
+    const QStringList others{QStringLiteral("PROBLEM1"), QStringLiteral("PROBLEM3"), QStringLiteral("PROBLEM4"),
+                             QStringLiteral("PROBLEM5"), QStringLiteral("PROBLEM6")};
+
+    QTest::newRow("no grouping") << int(NoGrouping) << (others + QStringList{QStringLiteral("REPLACEMENT")})
+                                 << others;
+    QTest::newRow("path grouping") << int(PathGrouping) << (others + QStringList{QStringLiteral("REPLACEMENT")})
+                                   << others;
+    QTest::newRow("severity grouping")
+        << int(SeverityGrouping)
+        << QStringList{QStringLiteral("PROBLEM1"),    QStringLiteral("PROBLEM3"), QStringLiteral("REPLACEMENT"),
+                       QStringLiteral("PROBLEM4"),    QStringLiteral("PROBLEM5"), QStringLiteral("PROBLEM6")}
+        << others;
+}
+
+void TestFilteredProblemStore::testReplaceProblems()
+{
+    QFETCH(int, grouping);
+    QFETCH(QStringList, afterReplace);
+    QFETCH(QStringList, afterRemove);
+
+    m_store->setSeverities(IProblem::Error | IProblem::Warning | IProblem::Hint);
+    m_store->setGrouping(grouping);
+    m_store->setProblems(m_problems);
+
+    const IndexedString document = m_problems[1]->finalLocation().document;
+    IProblem::Ptr replacement(new DetectedProblem());
+    replacement->setDescription(QStringLiteral("REPLACEMENT"));
+    replacement->setSeverity(IProblem::Warning);
+    replacement->setFinalLocation(m_problems[1]->finalLocation());
+
+    QSignalSpy rebuildSpy(m_store.data(), &ProblemStore::endRebuild);
+    QSignalSpy removeSpy(m_store.data(), &ProblemStore::beginRemoveNodes);
+    QSignalSpy insertSpy(m_store.data(), &ProblemStore::beginInsertNodes);
+    QSignalSpy changedSpy(m_store.data(), &ProblemStore::problemsChanged);
+
+    // Only the changed rows are announced, the tree is not rebuilt
+    m_store->replaceProblems(document, {replacement});
+    QCOMPARE(rebuildSpy.count(), 0);
+    QVERIFY(!removeSpy.isEmpty());
+    QVERIFY(!insertSpy.isEmpty());
+    QCOMPARE(changedSpy.count(), 1);
+    QVERIFY(m_store->problems(document) == QVector<IProblem::Ptr>{replacement});
+    QVERIFY(m_store->problems(m_problems[0]->finalLocation().document) == QVector<IProblem::Ptr>{m_problems[0]});
+    QCOMPARE(problemDescriptions(*m_store), afterReplace);
+
+    // Replacing the problems with the same ones changes nothing
+    removeSpy.clear();
+    insertSpy.clear();
+    m_store->replaceProblems(document, {replacement});
+    QVERIFY(removeSpy.isEmpty());
+    QVERIFY(insertSpy.isEmpty());
+    QCOMPARE(changedSpy.count(), 1);
+
+    m_store->removeProblems(document);
+    QVERIFY(!removeSpy.isEmpty());
+    QVERIFY(insertSpy.isEmpty());
+    QCOMPARE(rebuildSpy.count(), 0);
+    QCOMPARE(changedSpy.count(), 2);
+    QVERIFY(m_store->problems(document).isEmpty());
+    QCOMPARE(problemDescriptions(*m_store), afterRemove);
+
+    m_store->clear();
+    m_store->setGrouping(NoGrouping);
+}
+
 // Generate 3 problems, all with different paths, different severity
 // Also generates a problem with diagnostics
 void TestFilteredProblemStore::generateProblems()
@@ -4,9 +4,12 @@
     SPDX-License-Identifier: LGPL-2.0-or-later
 */
 
+#include <QAbstractItemModelTester>
+#include <QSignalSpy>
 #include <QTest>
 
 #include <shell/problemmodel.h>
+#include <shell/filteredproblemstore.h>
 #include <shell/problem.h>
 #include <shell/problemconstants.h>
 #include <language/editor/documentrange.h>
@@ -26,6 +29,23 @@
 
 using namespace KDevelop;
 
+namespace {
+/// @return the problems that @p model shows below @p parent, without the group labels
+QVector<IProblem::Ptr> shownProblems(const ProblemModel& model, const QModelIndex& parent = {})
+{
+    QVector<IProblem::Ptr> problems;
+    for (int row = 0; row < model.rowCount(parent); ++row) {
+        const QModelIndex index = model.index(row, 0, parent);
+        if (const auto problem = model.problemForIndex(index)) {
+            problems.append(problem);
+        } else {
+            problems += shownProblems(model, index);
+        }
+    }
+    return problems;
+}
+}
+
 class TestProblemModel : public QObject
 {
     Q_OBJECT
@@ -37,6 +57,8 @@ private Q_SLOTS:
     void testPathGrouping();
     void testSeverityGrouping();
     void testPlaceholderText();
+    void testReplaceProblems_data();
+    void testReplaceProblems();
 
 private:
     QString prependPathRoot(QString const& currentPath) const;
@@ -406,6 +428,54 @@ void TestProblemModel::testPlaceholderText()
     QVERIFY(checkLabel(0, QModelIndex(), text1));
 }
 
+void TestProblemModel::testReplaceProblems_data()
+{
+    QTest::addColumn<int>("grouping");
+
+    QTest::newRow("no grouping") << int(NoGrouping);
+    QTest::newRow("path grouping") << int(PathGrouping);
+    QTest::newRow("severity grouping") << int(SeverityGrouping);
+}
+
+void TestProblemModel::testReplaceProblems()
+{
+    QFETCH(int, grouping);
+
+    auto* store = new FilteredProblemStore();
+    ProblemModel model(nullptr, store);
+    model.setScope(BypassScopeFilter);
+    model.setGrouping(grouping);
+    model.setProblems(m_problems);
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+
+    const IndexedString document = m_problems[1]->finalLocation().document;
+    IProblem::Ptr replacement(new DetectedProblem());
+    replacement->setDescription(QStringLiteral("REPLACEMENT"));
+    replacement->setSeverity(IProblem::Error);
+    replacement->setFinalLocation(m_problems[1]->finalLocation());
+
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy removedSpy(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy insertedSpy(&model, &QAbstractItemModel::rowsInserted);
+
+    // Only the rows of the document change, the model is not reset
+    store->replaceProblems(document, {replacement});
+    QCOMPARE(resetSpy.count(), 0);
+    QVERIFY(!removedSpy.isEmpty());
+    QVERIFY(!insertedSpy.isEmpty());
+    auto problems = shownProblems(model);
+    QCOMPARE(problems.size(), m_problems.size());
+    QVERIFY(problems.contains(replacement));
+    QVERIFY(!problems.contains(m_problems[1]));
+
+    store->removeProblems(document);
+    QCOMPARE(resetSpy.count(), 0);
+    problems = shownProblems(model);
+    QCOMPARE(problems.size(), m_problems.size() - 1);
+    QVERIFY(!problems.contains(replacement));
+    QVERIFY(problems.contains(m_problems[0]));
+}
+
 // Needed because util/Path.cpp asserts e.g. C: on Windows
 QString TestProblemModel::prependPathRoot(QString const& currentPath) const
 {
@@ -10,6 +10,7 @@
 #include <shell/problem.h>
 #include <shell/problemstorenode.h>
 #include <shell/problemconstants.h>
+#include <language/editor/documentrange.h>
 
 #include <tests/testcore.h>
 #include <tests/autotestshell.h>
@@ -31,6 +32,7 @@ private Q_SLOTS:
     void testSeverity();
     void testSeverities();
     void testScope();
+    void testReplaceProblems();
 
 private:
     void generateProblems();
@@ -130,6 +132,53 @@ void TestProblemStore::testScope()
     QCOMPARE(spy.count(), 1);
 }
 
+void TestProblemStore::testReplaceProblems()
+{
+    const IndexedString document(QStringLiteral("/just/a/random/path"));
+    const IndexedString otherDocument(QStringLiteral("/just/another/path"));
+
+    const auto createProblem = [](const IndexedString& document) {
+        IProblem::Ptr problem(new DetectedProblem());
+        DocumentRange range;
+        range.document = document;
+        problem->setFinalLocation(range);
+        return problem;
+    };
+    const QVector<IProblem::Ptr> problems{createProblem(document), createProblem(otherDocument),
+                                          createProblem(document)};
+    m_store->setProblems(problems);
+    QVERIFY(m_store->problems(document) == (QVector<IProblem::Ptr>{problems[0], problems[2]}));
+    QVERIFY(m_store->problems(otherDocument) == QVector<IProblem::Ptr>{problems[1]});
+
+    QSignalSpy rebuildSpy(m_store.data(), &ProblemStore::endRebuild);
+    QSignalSpy removeSpy(m_store.data(), &ProblemStore::beginRemoveNodes);
+    QSignalSpy insertSpy(m_store.data(), &ProblemStore::beginInsertNodes);
+
+    // The rows of the document are removed from the last one, then the replacement is appended
+    const QVector<IProblem::Ptr> replacement{createProblem(document)};
+    m_store->replaceProblems(document, replacement);
+    QCOMPARE(rebuildSpy.count(), 0);
+    QCOMPARE(removeSpy.count(), 2);
+    QCOMPARE(removeSpy.at(0).at(1).toInt(), 2);
+    QCOMPARE(removeSpy.at(0).at(2).toInt(), 2);
+    QCOMPARE(removeSpy.at(1).at(1).toInt(), 0);
+    QCOMPARE(removeSpy.at(1).at(2).toInt(), 0);
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(insertSpy.at(0).at(1).toInt(), 1);
+    QCOMPARE(insertSpy.at(0).at(2).toInt(), 1);
+    QCOMPARE(m_store->count(), 2);
+    QVERIFY(m_store->problems(document) == replacement);
+    QVERIFY(m_store->findNode(0)->problem() == problems[1]);
+    QVERIFY(m_store->findNode(1)->problem() == replacement[0]);
+
+    m_store->removeProblems(otherDocument);
+    QCOMPARE(m_store->count(), 1);
+    QVERIFY(m_store->problems(otherDocument).isEmpty());
+
+    m_store->clear();
+    QVERIFY(m_store->problems(document).isEmpty());
+}
+
 void TestProblemStore::generateProblems()
 {
     for (int i = 0; i < 5; i++) {
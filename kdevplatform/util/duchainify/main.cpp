@@ -19,6 +19,9 @@
 #include <language/duchain/persistentsymboltable.h>
 
 #include <interfaces/ilanguagecontroller.h>
+#include <interfaces/iproject.h>
+#include <interfaces/iprojectcontroller.h>
+#include <interfaces/isessionlock.h>
 #include <tests/autotestshell.h>
 #include <tests/testcore.h>
 
@@ -26,12 +29,19 @@
 #include <QCommandLineParser>
 #include <QCommandLineOption>
 #include <QDebug>
+#include <QDir>
 #include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
 #include <QStringList>
 #include <QTimer>
 
 #include <cstdio>
 
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
 #include <KAboutData>
 #include <KLocalizedString>
 
@@ -70,8 +80,9 @@ Manager::Manager(QCommandLineParser* args) : m_total(0)
 
 void Manager::init()
 {
-    if (m_args->positionalArguments().isEmpty()) {
-        std::cerr << "Need file or directory to duchainify" << std::endl;
+    const auto projects = m_args->values(QStringLiteral("project"));
+    if (m_args->positionalArguments().isEmpty() && projects.isEmpty()) {
+        std::cerr << "Need file, directory or project to duchainify" << std::endl;
         QCoreApplication::exit(1);
     }
 
@@ -120,11 +131,56 @@ void Manager::init()
     connect(ICore::self()->languageController()->backgroundParser(), &BackgroundParser::hideProgress, this,
             &Manager::finishIfDone);
 
+    m_features = features;
+    // updateContextForUrl() may start parsing the files right away
+    m_timer.start();
     const auto files = m_args->positionalArguments();
     for (const auto& file : files) {
         addToBackgroundParser(file, features);
     }
 
+    if (!projects.isEmpty()) {
+        // the project managers import the build system information, e.g. via the CMake file API or a
+        // compile_commands.json file, so that the files are parsed with their real include paths and defines
+        auto* projectController = ICore::self()->projectController();
+        connect(projectController, &IProjectController::projectOpened, this, &Manager::projectOpened);
+        connect(projectController, &IProjectController::projectOpeningAborted, this, &Manager::projectOpeningAborted);
+        m_pendingProjects = projects.size();
+        for (const auto& project : projects) {
+            projectController->openProject(QUrl::fromLocalFile(QFileInfo(project).absoluteFilePath()));
+        }
+        return;
+    }
+
+    startParsing();
+}
+
+void Manager::projectOpened(IProject* project)
+{
+    std::cerr << "opened project " << qPrintable(project->name()) << std::endl;
+    const auto files = project->fileSet();
+    for (const auto& file : files) {
+        const auto url = file.toUrl();
+        if (!ICore::self()->languageController()->languagesForUrl(url).isEmpty()) {
+            addToBackgroundParser(url.toLocalFile(), m_features);
+        }
+    }
+
+    if (--m_pendingProjects == 0) {
+        startParsing();
+    }
+}
+
+void Manager::projectOpeningAborted(IProject* project)
+{
+    std::cerr << "failed to open project " << qPrintable(project->name()) << std::endl;
+    if (--m_pendingProjects == 0) {
+        startParsing();
+    }
+}
+
+void Manager::startParsing()
+{
     m_allFilesAdded = 1;
 
     if (m_total) {
@@ -225,8 +281,12 @@ void Manager::addToBackgroundParser(const QString& path, TopDUContext::Features
         qDebug() << "adding file" << path;
         QUrl pathUrl = QUrl::fromLocalFile(info.canonicalFilePath());
 
+        if (m_waiting.contains(pathUrl)) {
+            return;
+        }
         m_waiting << pathUrl;
         ++m_total;
+        m_totalBytes += info.size();
 
         KDevelop::DUChain::self()->updateContextForUrl(KDevelop::IndexedString(pathUrl), features, this);
 
@@ -250,15 +310,61 @@ void Manager::finishIfDone()
     if (m_exited) {
         return; // no need to exit again
     }
-    if (!m_waiting.empty() || !ICore::self()->languageController()->backgroundParser()->isIdle()) {
+    if (!m_allFilesAdded || !m_waiting.empty()
+        || !ICore::self()->languageController()->backgroundParser()->isIdle()) {
         return; // not ready to exit yet
     }
 
     std::cerr << "ready" << std::endl;
+    printStatistics();
     m_exited = true;
     QCoreApplication::quit();
 }
 
+void Manager::printStatistics() const
+{
+    const double seconds = m_timer.isValid() ? m_timer.elapsed() / 1000.0 : 0;
+    const double megabytes = m_totalBytes / (1024.0 * 1024.0);
+    std::cerr << "parsed " << m_total << " files (" << megabytes << " MB) in " << seconds << " s";
+    if (seconds > 0) {
+        std::cerr << ": " << m_total / seconds << " files/s, " << megabytes / seconds << " MB/s";
+    }
+    std::cerr << std::endl;
+
+#ifdef Q_OS_UNIX
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef Q_OS_MACOS
+        const double peakRssMegabytes = usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+        const double peakRssMegabytes = usage.ru_maxrss / 1024.0;
+#endif
+        std::cerr << "peak RSS: " << peakRssMegabytes << " MB" << std::endl;
+    }
+#endif
+}
+
+namespace {
+bool copyDirectory(const QString& source, const QString& destination)
+{
+    if (!QDir().mkpath(destination)) {
+        return false;
+    }
+    QDirIterator it(source, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    const QDir sourceDir(source);
+    while (it.hasNext()) {
+        const auto path = it.next();
+        const auto target = destination + QLatin1Char('/') + sourceDir.relativeFilePath(path);
+        QDir().mkpath(QFileInfo(target).path());
+        QFile::remove(target);
+        if (!QFile::copy(path, target)) {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
 using namespace KDevelop;
 
 int main(int argc, char** argv)
@@ -287,6 +393,14 @@ int main(int argc, char** argv)
                                             "Enforce an update of the top-contexts corresponding to the given files and all included files")});
     parser.addOption(QCommandLineOption{QStringList{QStringLiteral("t"), QStringLiteral("threads")},
                                         i18n("Number of threads to use"), QStringLiteral("count")});
+    parser.addOption(QCommandLineOption{QStringList{QStringLiteral("p"), QStringLiteral("project")},
+                                        i18n("Project file (.kdev4) to open, all its files are parsed with the "
+                                             "include paths and defines imported by its project manager"),
+                                        QStringLiteral("file")});
+    parser.addOption(QCommandLineOption{
+        QStringList{QStringLiteral("o"), QStringLiteral("output")},
+        i18n("Directory to copy the DUChain cache to when done"),
+        QStringLiteral("directory")});
     parser.addOption(QCommandLineOption{QStringList{QStringLiteral("f"), QStringLiteral("features")},
                                         i18n(
                                             "Features to build. Options: empty, simplified-visible-declarations, visible-declarations (default), all-declarations, all-declarations-and-uses, all-declarations-and-uses-and-AST"),
@@ -322,13 +436,24 @@ int main(int argc, char** argv)
 
     AutoTestShell::init();
     TestCore::initialize(Core::NoUi, QStringLiteral("duchainify"));
+    const auto repositoryPath = DUChain::repositoryPathForSession(ICore::self()->activeSessionLock());
     Manager manager(&parser);
 
     QTimer::singleShot(0, &manager, &Manager::init);
     int ret = app.exec();
 
+    // stores the DUChain to disk
     TestCore::shutdown();
 
+    if (ret == 0 && parser.isSet(QStringLiteral("output"))) {
+        const auto output = parser.value(QStringLiteral("output"));
+        if (!copyDirectory(repositoryPath, output)) {
+            std::cerr << "failed to copy the DUChain cache to " << qPrintable(output) << std::endl;
+            return 4;
+        }
+        std::cerr << "DUChain cache written to " << qPrintable(output) << std::endl;
+    }
+
     return ret;
 }
 
@@ -9,6 +9,7 @@
 
 #include <QObject>
 #include <QAtomicInt>
+#include <QElapsedTimer>
 #include <QUrl>
 
 #include <language/duchain/topducontext.h>
@@ -16,6 +17,10 @@
 
 class QCommandLineParser;
 
+namespace KDevelop {
+class IProject;
+}
+
 class Manager : public QObject
 {
     Q_OBJECT
@@ -26,8 +31,15 @@ public:
     QSet<QUrl> waiting();
 
 private:
+    void startParsing();
+    void printStatistics() const;
+
     QSet<QUrl> m_waiting;
     uint m_total;
+    qint64 m_totalBytes = 0;
+    int m_pendingProjects = 0;
+    KDevelop::TopDUContext::Features m_features = KDevelop::TopDUContext::VisibleDeclarationsAndContexts;
+    QElapsedTimer m_timer;
     bool m_exited = false;
     QCommandLineParser* m_args;
     QAtomicInt m_allFilesAdded;
@@ -37,6 +49,8 @@ public Q_SLOTS:
     void init();
     void updateReady(const KDevelop::IndexedString& url, const KDevelop::ReferencedTopDUContext& topContext);
     void finishIfDone();
+    void projectOpened(KDevelop::IProject* project);
+    void projectOpeningAborted(KDevelop::IProject* project);
     void dump(const KDevelop::ReferencedTopDUContext& topContext);
 };
 
@@ -27,6 +27,7 @@
 
 #include <project/projectmodel.h>
 #include <project/interfaces/ibuildsystemmanager.h>
+#include <serialization/indexedstring.h>
 
 #include "clangsettings/clangsettingsmanager.h"
 #include "duchain/clanghelpers.h"
@@ -218,6 +219,8 @@ ClangSupport* ClangParseJob::clang() const
 void ClangParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread* /*thread*/)
 {
     QReadLocker parseLock(languageSupport()->parseLock());
+    // destroyed before the parse lock is released, such that batched reference count changes are applied in time
+    const IndexedStringInternCache internCache;
 
     if (abortRequested()) {
         return;
@@ -261,9 +264,10 @@ void ClangParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread*
             return;
         }
         ctx->setAst(IAstContainer::Ptr(session.data()));
+        lock.unlock();
+        clang()->index()->poolTranslationUnit(session);
 
         if (minimumFeatures() & UpdateHighlighting) {
-            lock.unlock();
             languageSupport()->codeHighlighting()->highlightDUChain(ctx);
         }
         return;
@@ -274,6 +278,15 @@ void ClangParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread*
         if (abortRequested() || !isUpdateRequired(ParseSession::languageString())) {
             return;
         }
+        if (!(minimumFeatures() & TopDUContext::ForceUpdate)
+            && ClangHelpers::refreshUnchangedFiles(document(), m_environment, minimumFeatures())) {
+            {
+                DUChainReadLocker lock;
+                setDuChain(DUChain::self()->chainForDocument(document(), &m_environment));
+            }
+            highlightDUChain();
+            return;
+        }
     }
 
     ParseSession session(ClangIntegration::DUChainUtils::findParseSessionData(document(), m_environment.translationUnitUrl()));
@@ -327,10 +340,12 @@ void ClangParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread*
         return;
     }
 
+    bool astAttached = false;
     if (context) {
         if (minimumFeatures() & TopDUContext::AST) {
             DUChainWriteLocker lock;
             context->setAst(IAstContainer::Ptr(session.data()));
+            astAttached = true;
         }
 #ifdef QT_DEBUG
         DUChainReadLocker lock;
@@ -358,10 +373,16 @@ void ClangParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread*
                 // share the session data with all contexts that are pinned to this TU
                 DUChainWriteLocker lock;
                 context->setAst(IAstContainer::Ptr(session.data()));
+                astAttached = true;
             }
             languageSupport()->codeHighlighting()->highlightDUChain(context);
         }
     }
+
+    if (astAttached) {
+        // keep the translation unit for fast reparsing within the memory budget of the index
+        clang()->index()->poolTranslationUnit(session);
+    }
 }
 
 ParseSessionData::Ptr ClangParseJob::createSessionData() const
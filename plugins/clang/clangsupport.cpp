@@ -391,6 +391,7 @@ void ClangSupport::documentActivated(IDocument* doc)
 
     auto sessionData = ClangIntegration::DUChainUtils::findParseSessionData(indexedUrl, index()->translationUnitForUrl(IndexedString(doc->url())));
     if (sessionData) {
+        index()->useTranslationUnit(sessionData.data());
         return;
     }
 
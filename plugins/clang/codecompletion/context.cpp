@@ -954,6 +954,10 @@ ClangCodeCompletionContext::ClangCodeCompletionContext(const DUContextPointer& c
     qRegisterMetaType<MemberAccessReplacer::Type>();
     const QByteArray file = url.toLocalFile().toUtf8();
     ParseSession session(m_parseSessionData);
+    if (!session.unit()) {
+        qCWarning(KDEV_CLANG) << "The translation unit was disposed, no code completion for file" << file;
+        return;
+    }
 
     QVector<UnsavedFile> otherUnsavedFiles;
     {
@@ -102,6 +102,7 @@ private:
             qCWarning(KDEV_CLANG) << "No parse session / AST attached to context for url" << m_url;
             return;
         }
+        m_index->useTranslationUnit(sessionData.data());
 
         if (aborting()) {
             failed();
@@ -41,6 +41,7 @@
 
 #include <algorithm>
 #include <unordered_map>
+#include <vector>
 #include <typeinfo>
 
 
@@ -1594,10 +1595,15 @@ Visitor::Visitor(CXTranslationUnit tu, CXFile file,
     m_parentContext = &parent;
     clang_visitChildren(tuCursor, &visitCursor, this);
 
-    if (m_update) {
-        DUChainWriteLocker lock;
-        top->deleteUsesRecursively();
-    }
+    // resolve all uses first and only then create them in one go, to not take the global
+    // write lock once per use and thereby block all other parse jobs and the foreground
+    struct ResolvedUse
+    {
+        DUContext* context;
+        DeclarationPointer used;
+        RangeInRevision range;
+    };
+    std::vector<ResolvedUse> resolvedUses;
     for (const auto &contextUses : m_uses) {
         for (const auto &cursor : contextUses.second) {
             auto referenced = referencedCursor(cursor);
@@ -1638,10 +1644,21 @@ Visitor::Visitor(CXTranslationUnit tu, CXFile file,
             const auto useRange = clang_getCursorReferenceNameRange(cursor, 0, 0);
             const auto range = rangeInRevisionForUse(cursor, referenced.kind, useRange, m_macroExpansionLocations);
 
-            DUChainWriteLocker lock;
-            auto usedIndex = top->indexForUsedDeclaration(used.data());
-            contextUses.first->createUse(usedIndex, range);
+            resolvedUses.push_back({contextUses.first, used, range});
+        }
+    }
+
+    DUChainWriteLocker lock;
+    if (m_update) {
+        top->deleteUsesRecursively();
+    }
+    for (const auto& use : resolvedUses) {
+        // the declaration may have been deleted by another parse job in the meantime
+        if (!use.used) {
+            continue;
         }
+        auto usedIndex = top->indexForUsedDeclaration(use.used.data());
+        use.context->createUse(usedIndex, use.range);
     }
 }
 
@@ -25,8 +25,10 @@
 
 #include <QCoreApplication>
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
 #include <QRegularExpression>
+#include <QSet>
 
 #include <algorithm>
 
@@ -68,6 +70,23 @@ CXChildVisitResult visitCursor(CXCursor cursor, CXCursor, CXClientData data)
     return CXChildVisit_Recurse;
 }
 
+/**
+ * @return the hash of the contents of @p file as parsed in @p unit, or 0 if they are not available
+ */
+quint64 contentHash(CXTranslationUnit unit, CXFile file)
+{
+#if CINDEX_VERSION_MINOR >= 47
+    size_t size = 0;
+    if (const char* contents = clang_getFileContents(unit, file, &size)) {
+        return ClangParsingEnvironmentFile::hashContents(QByteArrayView(contents, size));
+    }
+#else
+    Q_UNUSED(unit);
+    Q_UNUSED(file);
+#endif
+    return 0;
+}
+
 ReferencedTopDUContext createTopContext(const IndexedString& path, const ClangParsingEnvironment& environment)
 {
     auto* file = new ClangParsingEnvironmentFile(path, environment);
@@ -198,6 +217,7 @@ ReferencedTopDUContext ClangHelpers::buildDUChain(CXFile file, const Imports& im
         } else {
             envFile->setModificationRevision(*it);
         }
+        envFile->setContentHash(contentHash(session.unit(), file));
     }
 
     const auto problems = session.problemsForFile(file);
@@ -206,6 +226,8 @@ ReferencedTopDUContext ClangHelpers::buildDUChain(CXFile file, const Imports& im
         context->setProblems(problems);
     }
 
+    // keep holding the URL parse lock while visiting, as the context already looks up to date
+    // to other translation units that include this file
     Builder::visit(session.unit(), file, includedFiles, update);
 
     DUChain::self()->emitUpdateReady(path, context);
@@ -213,6 +235,83 @@ ReferencedTopDUContext ClangHelpers::buildDUChain(CXFile file, const Imports& im
     return context;
 }
 
+bool ClangHelpers::refreshUnchangedFiles(const IndexedString& url, const ClangParsingEnvironment& environment,
+                                         TopDUContext::Features features)
+{
+    struct OutdatedFile
+    {
+        IndexedString path;
+        ModificationRevision revision;
+        ParsingEnvironmentFilePointer parsedFile;
+        quint64 contentHash;
+    };
+    QVector<OutdatedFile> outdatedFiles;
+    ClangParsingEnvironmentFile::Ptr file;
+    {
+        DUChainReadLocker lock;
+        const auto context = DUChain::self()->chainForDocument(url, &environment);
+        if (!context) {
+            return false;
+        }
+        file = dynamic_cast<ClangParsingEnvironmentFile*>(context->parsingEnvironmentFile().data());
+        if (!file || !file->featuresSatisfied(features) || file->environmentNeedsUpdate(environment)) {
+            return false;
+        }
+
+        const auto outdated = file->allModificationRevisions().outdatedRevisions();
+        for (const auto& [path, revision] : outdated) {
+            // find the file as it was parsed at the outdated revision
+            const auto parsedFiles = DUChain::self()->allEnvironmentFiles(path);
+            const auto parsedFile =
+                std::find_if(parsedFiles.begin(), parsedFiles.end(), [&revision](const ParsingEnvironmentFilePointer& parsed) {
+                    auto* const clangFile = dynamic_cast<ClangParsingEnvironmentFile*>(parsed.data());
+                    return clangFile && clangFile->contentHash() && clangFile->modificationRevision() == revision;
+                });
+            if (parsedFile == parsedFiles.end()) {
+                return false;
+            }
+            outdatedFiles.append({path, revision, *parsedFile,
+                                  static_cast<ClangParsingEnvironmentFile*>(parsedFile->data())->contentHash()});
+        }
+    }
+    if (outdatedFiles.isEmpty()) {
+        return false;
+    }
+
+    // e.g. after switching branches, many files are touched without changing their contents
+    for (const auto& outdated : std::as_const(outdatedFiles)) {
+        if (ModificationRevision::revisionForFile(outdated.path).revision) {
+            // modified in the editor
+            return false;
+        }
+        QFile contents(outdated.path.str());
+        if (!contents.open(QIODevice::ReadOnly)
+            || ClangParsingEnvironmentFile::hashContents(contents.readAll()) != outdated.contentHash) {
+            return false;
+        }
+    }
+
+    DUChainWriteLocker lock;
+    for (const auto& outdated : std::as_const(outdatedFiles)) {
+        const auto revision = ModificationRevision::revisionForFile(outdated.path);
+        // refresh the parsed file and everything that imports it, directly or indirectly
+        QVector<ParsingEnvironmentFilePointer> pending{outdated.parsedFile};
+        QSet<ParsingEnvironmentFile*> visited;
+        while (!pending.isEmpty()) {
+            const auto current = pending.takeLast();
+            if (visited.contains(current.data())) {
+                continue;
+            }
+            visited.insert(current.data());
+            current->replaceModificationRevision(outdated.path, outdated.revision, revision);
+            pending += current->importers();
+        }
+    }
+    clangDebug() << "contents of" << outdatedFiles.size() << "touched files did not change, skipping update of" << url;
+    // the files may have been updated while the DUChain was not locked
+    return !file->needsUpdate(&environment);
+}
+
 DeclarationPointer ClangHelpers::findDeclaration(CXSourceLocation location, const QualifiedIdentifier& id, const ReferencedTopDUContext& top)
 {
     if (!top) {
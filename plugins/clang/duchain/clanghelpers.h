@@ -19,6 +19,7 @@
 
 class ParseSession;
 class ClangIndex;
+class ClangParsingEnvironment;
 
 namespace KDevelop
 {
@@ -73,6 +74,17 @@ buildDUChain(CXFile file, const Imports& imports, const ParseSession& session,
              const UnsavedRevisions& unsavedRevisions, const KDevelop::IndexedString& parseDocument,
              ClangIndex* index = nullptr, const std::function<bool()>& abortFunction = {});
 
+/**
+ * Refreshes the outdated modification revisions of the context of @p url, if the outdated files
+ * were only touched, but their contents are the same as when they were parsed.
+ *
+ * The modification revisions are refreshed in all importers of the touched files, too.
+ * @returns true if the context is up to date afterwards and does not need to be parsed again
+ */
+KDEVCLANGPRIVATE_EXPORT bool refreshUnchangedFiles(const KDevelop::IndexedString& url,
+                                                   const ClangParsingEnvironment& environment,
+                                                   KDevelop::TopDUContext::Features features);
+
 /**
  * @return List of possible header extensions used for definition/declaration fallback switching
  */
@@ -9,6 +9,7 @@
 #include "clangpch.h"
 #include "clangparsingenvironment.h"
 #include "documentfinderhelpers.h"
+#include "parsesession.h"
 
 #include <interfaces/icompletionsettings.h>
 #include <interfaces/icore.h>
@@ -23,10 +24,19 @@
 
 #include <clang-c/Index.h>
 
+#include <algorithm>
+
 using namespace KDevelop;
 
 namespace {
 
+qint64 translationUnitPoolBudget()
+{
+    bool ok = false;
+    const auto budgetMiB = qEnvironmentVariableIntValue("KDEV_CLANG_TU_MEMORY_BUDGET", &ok);
+    return (ok && budgetMiB > 0 ? budgetMiB : 2048) * qint64(1024 * 1024);
+}
+
 CXIndex createIndex()
 {
     // NOTE: We don't exclude PCH declarations. That way we could retrieve imports manually,
@@ -80,6 +90,7 @@ CXIndex createIndex()
 
 ClangIndex::ClangIndex()
     : m_index(createIndex())
+    , m_poolBudget(translationUnitPoolBudget())
 {
 }
 
@@ -182,3 +193,89 @@ void ClangIndex::unpinTranslationUnitForUrl(const IndexedString& url)
     QMutexLocker lock(&m_mappingMutex);
     m_tuForUrl.remove(url);
 }
+
+void ClangIndex::poolTranslationUnit(const ParseSession& session)
+{
+    auto* const data = session.data().data();
+    if (!data || !session.unit()) {
+        return;
+    }
+    const auto memoryUsage = translationUnitMemoryUsage(session.unit());
+
+    QMutexLocker lock(&m_poolMutex);
+    auto it = std::find_if(m_pool.begin(), m_pool.end(), [data](const PooledTranslationUnit& pooled) {
+        return pooled.data == data;
+    });
+    if (it == m_pool.end()) {
+        m_pool.append({data, ++m_poolClock, memoryUsage});
+        data->m_pooled = true;
+    } else {
+        it->lastUse = ++m_poolClock;
+        it->memoryUsage = memoryUsage;
+    }
+
+    qint64 totalMemoryUsage = 0;
+    for (const auto& pooled : std::as_const(m_pool)) {
+        totalMemoryUsage += pooled.memoryUsage;
+    }
+    clangDebug() << "pooled translation unit" << session.environment().translationUnitUrl() << "uses"
+                 << memoryUsage / 1024 << "KiB, pool of" << m_pool.size() << "units uses"
+                 << totalMemoryUsage / 1024 << "KiB";
+    if (totalMemoryUsage <= m_poolBudget) {
+        return;
+    }
+
+    std::sort(m_pool.begin(), m_pool.end(), [](const PooledTranslationUnit& lhs, const PooledTranslationUnit& rhs) {
+        return lhs.lastUse < rhs.lastUse;
+    });
+    for (auto candidate = m_pool.begin(); candidate != m_pool.end() && totalMemoryUsage > m_poolBudget;) {
+        // never wait for a unit that is in use, we would deadlock with a thread that pools its unit
+        if (candidate->data == data || !candidate->data->m_mutex.tryLock()) {
+            ++candidate;
+            continue;
+        }
+        clangDebug() << "disposing least recently used translation unit"
+                     << candidate->data->m_environment.translationUnitUrl() << "of" << candidate->memoryUsage / 1024
+                     << "KiB";
+        candidate->data->disposeUnit();
+        candidate->data->m_pooled = false;
+        candidate->data->m_mutex.unlock();
+        totalMemoryUsage -= candidate->memoryUsage;
+        candidate = m_pool.erase(candidate);
+    }
+}
+
+void ClangIndex::useTranslationUnit(ParseSessionData* data)
+{
+    QMutexLocker lock(&m_poolMutex);
+    auto it = std::find_if(m_pool.begin(), m_pool.end(), [data](const PooledTranslationUnit& pooled) {
+        return pooled.data == data;
+    });
+    if (it != m_pool.end()) {
+        it->lastUse = ++m_poolClock;
+    }
+}
+
+void ClangIndex::removeTranslationUnit(ParseSessionData* data)
+{
+    QMutexLocker lock(&m_poolMutex);
+    m_pool.erase(std::remove_if(m_pool.begin(), m_pool.end(),
+                                [data](const PooledTranslationUnit& pooled) {
+                                    return pooled.data == data;
+                                }),
+                 m_pool.end());
+}
+
+qint64 ClangIndex::translationUnitMemoryUsage(CXTranslationUnit unit)
+{
+    auto usage = clang_getCXTUResourceUsage(unit);
+    qint64 memoryUsage = 0;
+    for (unsigned i = 0; i < usage.numEntries; ++i) {
+        const auto kind = usage.entries[i].kind;
+        if (kind >= CXTUResourceUsage_MEMORY_IN_BYTES_BEGIN && kind <= CXTUResourceUsage_MEMORY_IN_BYTES_END) {
+            memoryUsage += usage.entries[i].amount;
+        }
+    }
+    clang_disposeCXTUResourceUsage(usage);
+    return memoryUsage;
+}
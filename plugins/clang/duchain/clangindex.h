@@ -16,11 +16,14 @@
 
 #include <QReadWriteLock>
 #include <QSharedPointer>
+#include <QVector>
 
 #include <clang-c/Index.h>
 
 class ClangParsingEnvironment;
 class ClangPCH;
+class ParseSession;
+class ParseSessionData;
 
 class KDEVCLANGPRIVATE_EXPORT ClangIndex
 {
@@ -34,6 +37,8 @@ public:
      * @returns the existing ClangPCH for @p environment
      *
      * The PCH is created using @p environment if it doesn't exist
+     * A PCH saved by a previous session is reused as long as the arguments, defines
+     * and included headers did not change, see ParseSessionData.
      * This function is thread safe.
      */
     QSharedPointer<const ClangPCH> pch(const ClangParsingEnvironment& environment);
@@ -55,6 +60,34 @@ public:
      */
     void unpinTranslationUnitForUrl(const KDevelop::IndexedString& url);
 
+    /**
+     * Adds the translation unit of @p session to the pool of translation units kept for fast reparsing,
+     * or updates its memory usage if it is pooled already, and marks it as the most recently used one.
+     *
+     * Afterwards, the least recently used translation units of the pool are disposed until the pool fits
+     * into its memory budget again. The budget in MiB can be set with the KDEV_CLANG_TU_MEMORY_BUDGET
+     * environment variable. Translation units that are in use by another ParseSession are skipped.
+     */
+    void poolTranslationUnit(const ParseSession& session);
+
+    /**
+     * Marks the pooled translation unit of @p data as the most recently used one.
+     *
+     * Documents that are activated in the editor or code-completed are used this way, which
+     * keeps their translation units in the pool longer than those of documents in the background.
+     */
+    void useTranslationUnit(ParseSessionData* data);
+
+    /**
+     * Removes @p data from the pool, without disposing its translation unit.
+     */
+    void removeTranslationUnit(ParseSessionData* data);
+
+    /**
+     * @return the memory used by @p unit in bytes, as reported by clang_getCXTUResourceUsage
+     */
+    static qint64 translationUnitMemoryUsage(CXTranslationUnit unit);
+
 private:
     CXIndex m_index;
 
@@ -63,6 +96,17 @@ private:
 
     QMutex m_mappingMutex;
     QHash<KDevelop::IndexedString, KDevelop::IndexedString> m_tuForUrl;
+
+    struct PooledTranslationUnit
+    {
+        ParseSessionData* data;
+        quint64 lastUse;
+        qint64 memoryUsage;
+    };
+    QMutex m_poolMutex;
+    QVector<PooledTranslationUnit> m_pool;
+    quint64 m_poolClock = 0;
+    const qint64 m_poolBudget;
 };
 
 #endif //CLANGINDEX_H
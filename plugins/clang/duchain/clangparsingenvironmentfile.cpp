@@ -21,6 +21,7 @@ public:
         , environmentHash(0)
         , tuUrl()
         , quality(ClangParsingEnvironment::Unknown)
+        , contentHash(0)
     {
     }
 
@@ -29,6 +30,7 @@ public:
         , environmentHash(rhs.environmentHash)
         , tuUrl(rhs.tuUrl)
         , quality(rhs.quality)
+        , contentHash(rhs.contentHash)
     {
     }
 
@@ -37,6 +39,7 @@ public:
     uint environmentHash;
     IndexedString tuUrl;
     ClangParsingEnvironment::Quality quality;
+    quint64 contentHash;
 };
 
 ClangParsingEnvironmentFile::ClangParsingEnvironmentFile(const IndexedString& url,
@@ -64,15 +67,7 @@ bool ClangParsingEnvironmentFile::needsUpdate(const ParsingEnvironment* environm
 {
     if (environment) {
         Q_ASSERT(dynamic_cast<const ClangParsingEnvironment*>(environment));
-        auto env = static_cast<const ClangParsingEnvironment*>(environment);
-        if (env->quality() > d_func()->quality) {
-            clangDebug() << "Found better quality environment, require update:" << url()
-                << "new environment quality:" << env->quality()
-                << "old environment quality:" << d_func()->quality;
-            return true;
-        }
-        if (env->translationUnitUrl() == d_func()->tuUrl && env->hash() != d_func()->environmentHash) {
-            clangDebug() << "TU environment changed, require update" << url() << "TU url:" << env->translationUnitUrl() << "old hash:" << d_func()->environmentHash << "new hash:" << env->hash();
+        if (environmentNeedsUpdate(*static_cast<const ClangParsingEnvironment*>(environment))) {
             return true;
         }
     }
@@ -84,6 +79,21 @@ bool ClangParsingEnvironmentFile::needsUpdate(const ParsingEnvironment* environm
     return ret;
 }
 
+bool ClangParsingEnvironmentFile::environmentNeedsUpdate(const ClangParsingEnvironment& environment) const
+{
+    if (environment.quality() > d_func()->quality) {
+        clangDebug() << "Found better quality environment, require update:" << url()
+            << "new environment quality:" << environment.quality()
+            << "old environment quality:" << d_func()->quality;
+        return true;
+    }
+    if (environment.translationUnitUrl() == d_func()->tuUrl && environment.hash() != d_func()->environmentHash) {
+        clangDebug() << "TU environment changed, require update" << url() << "TU url:" << environment.translationUnitUrl() << "old hash:" << d_func()->environmentHash << "new hash:" << environment.hash();
+        return true;
+    }
+    return false;
+}
+
 void ClangParsingEnvironmentFile::setEnvironment(const ClangParsingEnvironment& environment)
 {
     d_func_dynamic()->tuUrl = environment.translationUnitUrl();
@@ -106,4 +116,20 @@ uint ClangParsingEnvironmentFile::environmentHash() const
     return d_func()->environmentHash;
 }
 
+void ClangParsingEnvironmentFile::setContentHash(quint64 hash)
+{
+    d_func_dynamic()->contentHash = hash;
+}
+
+quint64 ClangParsingEnvironmentFile::contentHash() const
+{
+    return d_func()->contentHash;
+}
+
+quint64 ClangParsingEnvironmentFile::hashContents(QByteArrayView contents)
+{
+    const quint64 hash = qHashBits(contents.data(), contents.size());
+    return hash ? hash : 1;
+}
+
 DUCHAIN_DEFINE_TYPE(ClangParsingEnvironmentFile)
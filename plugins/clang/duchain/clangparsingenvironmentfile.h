@@ -24,6 +24,10 @@ public:
     ~ClangParsingEnvironmentFile() override;
 
     bool needsUpdate(const KDevelop::ParsingEnvironment* environment = nullptr) const override;
+    /**
+     * @return true when @p environment requires an update, independent of the modification revisions
+     */
+    bool environmentNeedsUpdate(const ClangParsingEnvironment& environment) const;
     int type() const override;
 
     bool matchEnvironment(const KDevelop::ParsingEnvironment* environment) const override;
@@ -34,6 +38,17 @@ public:
 
     uint environmentHash() const;
 
+    /**
+     * Sets the hash of the contents this file was parsed from, see hashContents(). 0 means unknown.
+     */
+    void setContentHash(quint64 hash);
+    quint64 contentHash() const;
+
+    /**
+     * @return the hash of @p contents, which is never 0
+     */
+    static quint64 hashContents(QByteArrayView contents);
+
     enum {
         Identity = 142
     };
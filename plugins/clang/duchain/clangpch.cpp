@@ -11,6 +11,9 @@
 #include "clanghelpers.h"
 #include "util/clangtypes.h"
 #include "clangparsingenvironment.h"
+#include "util/clangdebug.h"
+
+#include <QElapsedTimer>
 
 using namespace KDevelop;
 
@@ -30,6 +33,9 @@ ClangPCH::ClangPCH(const ClangParsingEnvironment& environment, ClangIndex* index
     const auto& pchInclude = environment.pchInclude();
     Q_ASSERT(pchInclude.isValid());
 
+    QElapsedTimer timer;
+    timer.start();
+
     const TopDUContext::Features pchFeatures = TopDUContext::AllDeclarationsContextsUsesAndAST;
     const IndexedString doc(pchInclude.pathOrUrl());
 
@@ -44,6 +50,7 @@ ClangPCH::ClangPCH(const ClangParsingEnvironment& environment, ClangIndex* index
 
     auto imports = ClangHelpers::tuImports(m_session.unit());
     m_context = ClangHelpers::buildDUChain(m_session.mainFile(), imports, m_session, pchFeatures, m_includes, {}, {});
+    clangDebug() << "PCH for" << doc << "ready after" << timer.elapsed() << "ms";
 }
 
 IncludeFileContexts ClangPCH::mapIncludes(CXTranslationUnit tu) const
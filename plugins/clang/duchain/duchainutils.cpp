@@ -83,7 +83,11 @@ ParseSessionData::Ptr DUChainUtils::findParseSessionData(const IndexedString &fi
     }
 
     if (context) {
-        return ParseSessionData::Ptr(dynamic_cast<ParseSessionData*>(context->ast().data()));
+        ParseSessionData::Ptr data(dynamic_cast<ParseSessionData*>(context->ast().data()));
+        // the unit may still be disposed until the data is locked, ParseSession checks that again
+        if (data && !data->isDisposed()) {
+            return data;
+        }
     }
     return {};
 }
@@ -25,10 +25,14 @@
 
 #include <KShell>
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 #include <QMimeDatabase>
 #include <QMimeType>
+#include <QSaveFile>
 
 #include <algorithm>
 
@@ -232,12 +236,113 @@ const QString& definesFileTemplateName()
     static const QString ret = ICore::self()->sessionTemporaryDirectoryPath() + QLatin1String("/defines.XXXXXX");
     return ret;
 }
+
+/// Bump when changing the layout of the PCH cache files.
+const quint32 pchCacheVersion = 1;
+
+using FileTimes = QVector<QPair<QString, qint64>>;
+
+/**
+ * @return the file that describes the PCH saved for @p pchInclude by a previous session
+ *
+ * The PCH itself is stored next to the header, where clang looks for it when the header is included.
+ */
+QString pchCacheFile(const IndexedString& pchInclude)
+{
+    const auto hash = QCryptographicHash::hash(pchInclude.byteArray(), QCryptographicHash::Sha1).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/clangpch/")
+        + QString::fromLatin1(hash);
+}
+
+/**
+ * @return a hash of everything that influences the PCH besides the contents of the included files
+ *
+ * The defines file has a new temporary name in every session, so its contents are hashed instead of its name.
+ */
+QByteArray pchCacheKey(const QVector<const char*>& arguments, const char* definesFileArgument,
+                       const QMap<QString, QString>& defines)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(ClangString(clang_getClangVersion()).toByteArray());
+    for (const char* argument : arguments) {
+        if (argument != definesFileArgument) {
+            hash.addData(QByteArrayView(argument, qstrlen(argument) + 1));
+        }
+    }
+    for (auto it = defines.begin(); it != defines.end(); ++it) {
+        hash.addData(it.key().toUtf8());
+        hash.addData(QByteArrayView("=", 1));
+        hash.addData(it.value().toUtf8());
+        hash.addData(QByteArrayView("\n", 1));
+    }
+    return hash.result();
+}
+
+qint64 modificationTime(const QString& path)
+{
+    const QFileInfo info(path);
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+/**
+ * @return true when the PCH saved by a previous session was built with @p key
+ *         and neither the PCH nor any of the headers it includes changed since then
+ */
+bool isPchCacheValid(const QString& cacheFile, const QByteArray& key)
+{
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 version = 0;
+    stream >> version;
+    if (version != pchCacheVersion) {
+        return false;
+    }
+
+    QByteArray storedKey;
+    FileTimes fileTimes;
+    stream >> storedKey >> fileTimes;
+    if (stream.status() != QDataStream::Ok || storedKey != key || fileTimes.isEmpty()) {
+        return false;
+    }
+
+    return std::all_of(fileTimes.cbegin(), fileTimes.cend(), [](const QPair<QString, qint64>& fileTime) {
+        return modificationTime(fileTime.first) == fileTime.second;
+    });
+}
+
+void writePchCache(const QString& cacheFile, const QByteArray& key, CXTranslationUnit unit, const QString& pchFile)
+{
+    FileTimes fileTimes;
+    fileTimes.append({pchFile, modificationTime(pchFile)});
+    clang_getInclusions(
+        unit,
+        [](CXFile file, CXSourceLocation*, unsigned, CXClientData data) {
+            const auto path = ClangString(clang_getFileName(file)).toString();
+            static_cast<FileTimes*>(data)->append({path, modificationTime(path)});
+        },
+        &fileTimes);
+
+    QDir().mkpath(QFileInfo(cacheFile).path());
+    QSaveFile file(cacheFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KDEV_CLANG) << "failed to write PCH cache file" << cacheFile << file.errorString();
+        return;
+    }
+    QDataStream stream(&file);
+    stream << pchCacheVersion << key << fileTimes;
+    file.commit();
+}
 }
 
 ParseSessionData::ParseSessionData(const QVector<UnsavedFile>& unsavedFiles, ClangIndex* index,
                                    const ClangParsingEnvironment& environment, Options options)
     : m_file(nullptr)
     , m_unit(nullptr)
+    , m_index(index)
     , m_definesFile(definesFileTemplateName())
 {
     unsigned int flags = CXTranslationUnit_DetailedPreprocessingRecord
@@ -333,9 +438,11 @@ ParseSessionData::ParseSessionData(const QVector<UnsavedFile>& unsavedFiles, Cla
     smartArgs << ClangHelpers::clangBuiltinIncludePath().toUtf8();
     clangArguments << "-isystem" << smartArgs.last().constData();
 
+    const char* definesFileArgument;
     {
         smartArgs << writeDefinesFile(environment.defines());
-        clangArguments << "-imacros" << smartArgs.last().constData();
+        definesFileArgument = smartArgs.last().constData();
+        clangArguments << "-imacros" << definesFileArgument;
     }
 
     if (!environment.workingDirectory().isEmpty()) {
@@ -366,17 +473,38 @@ ParseSessionData::ParseSessionData(const QVector<UnsavedFile>& unsavedFiles, Cla
         out << " " << tuUrl.byteArray().constData() << "\n";
     }
 
-    const CXErrorCode code = clang_parseTranslationUnit2(
-        index->index(), tuUrl.byteArray().constData(),
-        clangArguments.constData(), clangArguments.size(),
-        unsaved.data(), unsaved.size(),
-        flags,
-        &m_unit
-    );
-    if (code != CXError_Success) {
-        qCWarning(KDEV_CLANG) << "clang_parseTranslationUnit2 return with error code" << code;
-        if (!qEnvironmentVariableIsSet("KDEV_CLANG_DISPLAY_DIAGS")) {
-            qCWarning(KDEV_CLANG) << "  (start KDevelop with `KDEV_CLANG_DISPLAY_DIAGS=1 kdevelop` to see more diagnostics)";
+    const QByteArray pchFile = tuUrl.byteArray() + ".pch";
+    QString pchCacheFile;
+    QByteArray pchCacheKey;
+    bool pchFromCache = false;
+    if (options.testFlag(PrecompiledHeader)) {
+        pchCacheFile = ::pchCacheFile(tuUrl);
+        pchCacheKey = ::pchCacheKey(clangArguments, definesFileArgument, environment.defines());
+        if (isPchCacheValid(pchCacheFile, pchCacheKey)) {
+            // reuse the PCH saved by a previous session instead of parsing the whole header again
+            const CXErrorCode code = clang_createTranslationUnit2(index->index(), pchFile.constData(), &m_unit);
+            if (code == CXError_Success) {
+                pchFromCache = true;
+            } else {
+                qCWarning(KDEV_CLANG) << "failed to load cached PCH" << pchFile << "error code" << code;
+                m_unit = nullptr;
+            }
+        }
+    }
+
+    if (!m_unit) {
+        const CXErrorCode code = clang_parseTranslationUnit2(
+            index->index(), tuUrl.byteArray().constData(),
+            clangArguments.constData(), clangArguments.size(),
+            unsaved.data(), unsaved.size(),
+            flags,
+            &m_unit
+        );
+        if (code != CXError_Success) {
+            qCWarning(KDEV_CLANG) << "clang_parseTranslationUnit2 return with error code" << code;
+            if (!qEnvironmentVariableIsSet("KDEV_CLANG_DISPLAY_DIAGS")) {
+                qCWarning(KDEV_CLANG) << "  (start KDevelop with `KDEV_CLANG_DISPLAY_DIAGS=1 kdevelop` to see more diagnostics)";
+            }
         }
     }
 
@@ -384,8 +512,10 @@ ParseSessionData::ParseSessionData(const QVector<UnsavedFile>& unsavedFiles, Cla
         setUnit(m_unit);
         m_environment = environment;
 
-        if (options.testFlag(PrecompiledHeader)) {
-            clang_saveTranslationUnit(m_unit, QByteArray(tuUrl.byteArray() + ".pch").constData(), CXSaveTranslationUnit_None);
+        if (options.testFlag(PrecompiledHeader) && !pchFromCache) {
+            if (clang_saveTranslationUnit(m_unit, pchFile.constData(), CXSaveTranslationUnit_None) == CXSaveError_None) {
+                writePchCache(pchCacheFile, pchCacheKey, m_unit, QString::fromUtf8(pchFile));
+            }
         }
     } else {
         qCWarning(KDEV_CLANG) << "Failed to parse translation unit:" << tuUrl;
@@ -394,6 +524,9 @@ ParseSessionData::ParseSessionData(const QVector<UnsavedFile>& unsavedFiles, Cla
 
 ParseSessionData::~ParseSessionData()
 {
+    if (m_pooled) {
+        m_index->removeTranslationUnit(this);
+    }
     clang_disposeTranslationUnit(m_unit);
 }
 
@@ -460,12 +593,25 @@ ClangParsingEnvironment ParseSessionData::environment() const
     return m_environment;
 }
 
+bool ParseSessionData::isDisposed() const
+{
+    return m_disposed;
+}
+
+void ParseSessionData::disposeUnit()
+{
+    clang_disposeTranslationUnit(m_unit);
+    setUnit(nullptr);
+    m_disposed = true;
+}
+
 ParseSession::ParseSession(const ParseSessionData::Ptr& data)
     : d(data)
 {
     if (d) {
         ENSURE_CHAIN_NOT_LOCKED
         d->m_mutex.lock();
+        dropDisposedData();
     }
 }
 
@@ -491,6 +637,17 @@ void ParseSession::setData(const ParseSessionData::Ptr& data)
     if (d) {
         ENSURE_CHAIN_NOT_LOCKED
         d->m_mutex.lock();
+        dropDisposedData();
+    }
+}
+
+void ParseSession::dropDisposedData()
+{
+    // The ClangIndex disposes pooled units only while holding their mutex, so the unit
+    // cannot be disposed anymore once we have the lock, but it may have been before.
+    if (d->isDisposed()) {
+        d->m_mutex.unlock();
+        d.reset();
     }
 }
 
@@ -667,7 +824,7 @@ CXFile ParseSession::mainFile() const
 
 bool ParseSession::reparse(const QVector<UnsavedFile>& unsavedFiles, const ClangParsingEnvironment& environment)
 {
-    if (!d || environment != d->m_environment) {
+    if (!d || !d->m_unit || environment != d->m_environment) {
         return false;
     }
 
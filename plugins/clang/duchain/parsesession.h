@@ -11,6 +11,8 @@
 #include <QList>
 #include <QTemporaryFile>
 
+#include <atomic>
+
 #include <clang-c/Index.h>
 
 #include <serialization/indexedstring.h>
@@ -52,15 +54,27 @@ public:
 
     ClangParsingEnvironment environment() const;
 
+    /**
+     * @return true when the translation unit was disposed to keep the memory budget of the ClangIndex
+     *
+     * Such data must not be used anymore, the document needs to be parsed again instead.
+     */
+    bool isDisposed() const;
+
 private:
     friend class ParseSession;
+    friend class ClangIndex;
     void setUnit(CXTranslationUnit unit);
+    void disposeUnit();
     QByteArray writeDefinesFile(const QMap<QString, QString>& defines);
 
     QMutex m_mutex;
 
     CXFile m_file = nullptr;
     CXTranslationUnit m_unit = nullptr;
+    ClangIndex* const m_index;
+    std::atomic<bool> m_pooled = false;
+    std::atomic<bool> m_disposed = false;
     ClangParsingEnvironment m_environment;
     /// TODO: share this file for all TUs that use the same defines (probably most in a project)
     ///       best would be a PCH, if possible
@@ -85,6 +99,8 @@ public:
 
     /**
      * Initialize a parse session with the given data and, if that data is valid, lock its mutex.
+     *
+     * If the translation unit of @p data was disposed, the session is initialized without data.
      */
     explicit ParseSession(const ParseSessionData::Ptr& data);
     /**
@@ -94,6 +110,8 @@ public:
 
     /**
      * Unlocks the mutex of the currently set ParseSessionData, and instead acquire the lock in @p data.
+     *
+     * If the translation unit of @p data was disposed, the session is left without data.
      */
     void setData(const ParseSessionData::Ptr& data);
     ParseSessionData::Ptr data() const;
@@ -119,6 +137,9 @@ public:
 private:
     Q_DISABLE_COPY(ParseSession)
 
+    /// Unlocks and drops the data, if its translation unit was disposed. The data must be locked.
+    void dropDisposedData();
+
     ClangProblem::Ptr getOrCreateProblem(int indexInTU, CXDiagnostic diagnostic) const;
     
     ClangProblem::Ptr createExternalProblem(int indexInTU,
@@ -16,6 +16,14 @@ UnsavedFile::UnsavedFile(const QString& fileName, const QStringList& contents)
 {
 }
 
+UnsavedFile UnsavedFile::fromUtf8(const QString& fileName, const QByteArray& contentsUtf8)
+{
+    UnsavedFile file(fileName);
+    file.m_fileNameUtf8 = fileName.toUtf8();
+    file.m_contentsUtf8 = contentsUtf8;
+    return file;
+}
+
 CXUnsavedFile UnsavedFile::toClangApi() const
 {
     if (m_fileNameUtf8.isEmpty()) {
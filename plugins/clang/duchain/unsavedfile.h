@@ -21,6 +21,11 @@ class KDEVCLANGPRIVATE_EXPORT UnsavedFile
 public:
     explicit UnsavedFile(const QString& fileName = {}, const QStringList& contents = {});
 
+    /**
+     * Wrap the already UTF-8 encoded @p contentsUtf8 without converting or copying it.
+     */
+    static UnsavedFile fromUtf8(const QString& fileName, const QByteArray& contentsUtf8);
+
     CXUnsavedFile toClangApi() const;
 
 private:
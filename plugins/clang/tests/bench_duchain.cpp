@@ -14,6 +14,14 @@
 #include <tests/testfile.h>
 #include <language/duchain/duchainlock.h>
 #include <language/duchain/duchain.h>
+#include <language/backgroundparser/backgroundparser.h>
+#include <interfaces/icore.h>
+#include <interfaces/ilanguagecontroller.h>
+
+#include <QThread>
+
+#include <memory>
+#include <vector>
 
 using namespace KDevelop;
 
@@ -62,6 +70,55 @@ void BenchDUChain::benchDUChainBuilder()
     }
 }
 
+namespace {
+QByteArray createCode(int index)
+{
+    const auto prefix = QByteArray::number(index);
+    QByteArray code;
+    for (int i = 0; i < 200; ++i) {
+        const auto id = prefix + '_' + QByteArray::number(i);
+        code += "struct Struct" + id + " { int member; Struct" + id + "* next; };\n";
+        code += "int func" + id + "(Struct" + id + "* s) { int sum = 0; while (s) { sum += s->member; s = s->next; } return sum; }\n";
+    }
+    return code;
+}
+}
+
+void BenchDUChain::benchDUChainBuilderScaling_data()
+{
+    QTest::addColumn<int>("threads");
+
+    const int maxThreads = qMax(2, QThread::idealThreadCount());
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        QTest::addRow("%d", threads) << threads;
+    }
+}
+
+void BenchDUChain::benchDUChainBuilderScaling()
+{
+    QFETCH(int, threads);
+
+    // independent translation units, i.e. the DUChain building of the files does not need to be serialized
+    auto* backgroundParser = ICore::self()->languageController()->backgroundParser();
+    const int oldThreadCount = backgroundParser->threadCount();
+    backgroundParser->setThreadCount(threads);
+
+    constexpr int fileCount = 32;
+    QBENCHMARK_ONCE {
+        std::vector<std::unique_ptr<TestFile>> files;
+        files.reserve(fileCount);
+        for (int i = 0; i < fileCount; ++i) {
+            files.push_back(std::make_unique<TestFile>(QString::fromUtf8(createCode(i)), QStringLiteral("cpp")));
+            files.back()->parse(TopDUContext::AllDeclarationsContextsAndUses);
+        }
+        for (const auto& file : files) {
+            QVERIFY(file->waitForParsed(60000));
+        }
+    }
+
+    backgroundParser->setThreadCount(oldThreadCount);
+}
+
 QTEST_MAIN(BenchDUChain)
 
 #include "moc_bench_duchain.cpp"
@@ -22,6 +22,8 @@ private Q_SLOTS:
     void cleanupTestCase();
 
     void benchDUChainBuilder();
+    void benchDUChainBuilderScaling_data();
+    void benchDUChainBuilderScaling();
 
 private:
 };
@@ -9,6 +9,7 @@
 #include "../util/clangutils.h"
 #include "../util/clangtypes.h"
 #include "../util/clangdebug.h"
+#include "../duchain/unsavedfile.h"
 
 #include <language/editor/documentrange.h>
 #include <tests/testcore.h>
@@ -262,6 +263,21 @@ void TestClangUtils::testRangeForIncludePathSpec()
     QCOMPARE(ClangUtils::rangeForIncludePathSpec("#include \"foo<>.h\""), KTextEditor::Range(0, 10, 0, 17));
 }
 
+void TestClangUtils::testUnsavedFileFromUtf8()
+{
+    const auto fileName = QStringLiteral("/tmp/änderung.cpp");
+    const UnsavedFile lines(fileName, {QStringLiteral("int ä;"), QString(), QStringLiteral("}")});
+    const QByteArray contents = QStringLiteral("int ä;\n\n}\n").toUtf8();
+    const auto utf8 = UnsavedFile::fromUtf8(fileName, contents);
+
+    const auto fromLines = lines.toClangApi();
+    const auto fromUtf8 = utf8.toClangApi();
+    QCOMPARE(QByteArray(fromUtf8.Filename), QByteArray(fromLines.Filename));
+    QCOMPARE(QByteArray(fromUtf8.Contents, fromUtf8.Length), QByteArray(fromLines.Contents, fromLines.Length));
+    // the buffer is shared, not copied
+    QCOMPARE(fromUtf8.Contents, contents.constData());
+}
+
 void TestClangUtils::testGetCursorSignature()
 {
     QFETCH(QByteArray, code);
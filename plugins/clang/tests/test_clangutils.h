@@ -24,6 +24,7 @@ private Q_SLOTS:
     void testGetRawContents();
     void testGetRawContents_data();
     void testRangeForIncludePathSpec();
+    void testUnsavedFileFromUtf8();
     void testGetCursorSignature();
     void testGetCursorSignature_data();
 };
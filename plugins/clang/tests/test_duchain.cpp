@@ -31,6 +31,7 @@
 #include <language/duchain/use.h>
 #include <language/duchain/duchaindumper.h>
 #include <language/backgroundparser/backgroundparser.h>
+#include <language/editor/modificationrevision.h>
 #include <interfaces/ilanguagecontroller.h>
 #include <interfaces/idocumentcontroller.h>
 #include <util/kdevstringhandler.h>
@@ -46,12 +47,16 @@
 #include <KConfigGroup>
 
 #include <QTest>
+#include <QDateTime>
+#include <QFile>
 #include <QSignalSpy>
 #include <QLoggingCategory>
 #include <QThread>
 #include <QVector>
 #include <QVersionNumber>
 
+#include <atomic>
+
 QTEST_MAIN(TestDUChain)
 
 using namespace KDevelop;
@@ -1920,6 +1925,68 @@ void TestDUChain::testReparseUnchanged()
     checkProblems(true);
 }
 
+void TestDUChain::testRefreshUnchangedFiles_data()
+{
+    QTest::addColumn<bool>("changeContents");
+    QTest::addColumn<bool>("changeEnvironment");
+    QTest::addColumn<bool>("requireAst");
+    QTest::addColumn<bool>("reparsed");
+
+    QTest::newRow("touched") << false << false << false << false;
+    QTest::newRow("changed") << true << false << false << true;
+    QTest::newRow("environment") << false << true << false << true;
+    QTest::newRow("missing-features") << false << false << true << true;
+}
+
+void TestDUChain::testRefreshUnchangedFiles()
+{
+    QFETCH(bool, changeContents);
+    QFETCH(bool, changeEnvironment);
+    QFETCH(bool, requireAst);
+    QFETCH(bool, reparsed);
+
+    TestFile header(QStringLiteral("int foo();\n"), QStringLiteral("h"));
+    TestFile impl("#include \"" + header.url().str() + "\"\n"
+                  "int main() { return foo(); }", QStringLiteral("cpp"), &header);
+    QVERIFY(impl.parseAndWait(TopDUContext::AllDeclarationsContextsAndUses));
+
+    // e.g. after switching branches, the header is written again
+    if (changeContents) {
+        header.setFileContents(QStringLiteral("int foo();\nint bar();\n"));
+    }
+    {
+        QFile file(header.url().str());
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(10), QFileDevice::FileModificationTime));
+    }
+    ModificationRevision::clearModificationCache(header.url());
+    if (changeEnvironment) {
+        m_provider->defines.insert(QStringLiteral("SOME_DEFINE"), QStringLiteral("1"));
+    }
+
+    std::atomic<int> implUpdates = 0;
+    QObject receiver;
+    connect(DUChain::self(), &DUChain::updateReady, &receiver,
+            [&implUpdates, url = impl.url()](const IndexedString& updatedUrl) {
+                if (updatedUrl == url) {
+                    ++implUpdates;
+                }
+            }, Qt::DirectConnection);
+
+    const auto features = requireAst ? TopDUContext::AllDeclarationsContextsAndUses | TopDUContext::AST
+                                     : TopDUContext::AllDeclarationsContextsAndUses;
+    QVERIFY(impl.parseAndWait(features));
+    QCOMPARE(implUpdates > 0, reparsed);
+
+    DUChainReadLocker lock;
+    QVERIFY(impl.topContext());
+    QVERIFY(!impl.topContext()->parsingEnvironmentFile()->needsUpdate());
+    QCOMPARE(impl.topContext()->localDeclarations().size(), 1);
+    auto headerCtx = DUChain::self()->chainForDocument(header.url());
+    QVERIFY(headerCtx);
+    QCOMPARE(headerCtx->localDeclarations().size(), changeContents ? 2 : 1);
+}
+
 void TestDUChain::testTypeAliasTemplate()
 {
     TestFile file(QStringLiteral("template <typename T> using Alias = T; using Foo = Alias<int>;"), QStringLiteral("cpp"));
@@ -85,6 +85,8 @@ private Q_SLOTS:
     void testLambda();
     void testReparseUnchanged_data();
     void testReparseUnchanged();
+    void testRefreshUnchangedFiles_data();
+    void testRefreshUnchangedFiles();
     void testTypeAliasTemplate();
     void testDeclarationsInsideMacroExpansion();
     void testForwardTemplateTypeParameterContext();
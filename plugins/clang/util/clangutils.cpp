@@ -19,6 +19,8 @@
 
 #include <KTextEditor/Document>
 
+#include <QHash>
+#include <QMutex>
 #include <QTextStream>
 #include <QRegularExpression>
 
@@ -45,23 +47,49 @@ CXCursor ClangUtils::getCXCursor(int line, int column, const CXTranslationUnit&
     return clang_getCursor(unit, location);
 }
 
+namespace {
+struct Utf8Snapshot
+{
+    qint64 revision;
+    int lines;
+    QByteArray contents;
+};
+}
+
 QVector<UnsavedFile> ClangUtils::unsavedFiles()
 {
+    // UTF-8 contents of the unsaved documents, shared by all parse and code completion jobs
+    // such that unchanged documents are not converted again for every job
+    static QMutex snapshotsMutex;
+    static QHash<QString, Utf8Snapshot> snapshots;
+
+    QMutexLocker lock(&snapshotsMutex);
+    QHash<QString, Utf8Snapshot> currentSnapshots;
     QVector<UnsavedFile> ret;
     const auto documents = ICore::self()->documentController()->openDocuments();
     for (auto* document : documents) {
         auto textDocument = document->textDocument();
-        // TODO: Introduce a cache so we don't have to re-read all the open documents
-        // which were not changed since the last run
         if (!textDocument || !textDocument->url().isLocalFile() || !textDocument->isModified()) {
             continue;
         }
         if (!DocumentFinderHelpers::mimeTypesList().contains(textDocument->mimeType())) {
             continue;
         }
-        ret << UnsavedFile(textDocument->url().toLocalFile(),
-                           textDocument->textLines(textDocument->documentRange()));
+
+        const auto path = textDocument->url().toLocalFile();
+        const auto revision = textDocument->revision();
+        const auto lines = textDocument->lines();
+        auto snapshot = snapshots.value(path);
+        if (snapshot.contents.isNull() || snapshot.revision != revision || snapshot.lines != lines) {
+            // convert at once instead of line by line, every line is terminated by a newline
+            snapshot = {revision, lines, textDocument->text().toUtf8()};
+            snapshot.contents.append('\n');
+        }
+        ret << UnsavedFile::fromUtf8(path, snapshot.contents);
+        currentSnapshots.insert(path, snapshot);
     }
+    // forget the documents that were closed or saved in the meantime
+    snapshots = currentSnapshots;
     return ret;
 }
 
@@ -100,6 +100,11 @@ public:
 
     CommandFlags flags() const {return flags_;}
 
+    /**
+     * Set the flags. This is done by \ref MICommandQueue, when the command replaces a queued one.
+     */
+    void setFlags(CommandFlags flags) {flags_ = flags;}
+
     /**
      * Returns the MI token with which the command is sent, allowing the parser to match up
      * the result message with the command.
@@ -10,6 +10,9 @@
 #include "micommand.h"
 #include "debuglog.h"
 
+#include <algorithm>
+#include <iterator>
+
 using namespace KDevMI::MI;
 
 CommandQueue::CommandQueue() = default;
@@ -63,6 +66,29 @@ void CommandQueue::rationalizeQueue(MICommand* command)
             return false;
         };
         m_commandList.erase(std::remove_if(m_commandList.begin(), m_commandList.end(), predicate), m_commandList.end());
+    } else if (command->type() == VarUpdate) {
+        // The same variable update still waiting in the queue reports all changes since the previous update
+        // too, so only one of them is kept. This way only one round trip is made, however often the variables
+        // are updated for one stop of the program.
+        const auto newCommandIt = std::prev(m_commandList.end());
+        const auto queuedIt = std::find_if(m_commandList.begin(), newCommandIt, [command](const auto& queuedCommand) {
+            return queuedCommand->type() == VarUpdate && queuedCommand->command() == command->command()
+                && queuedCommand->thread() == command->thread() && queuedCommand->frame() == command->frame();
+        });
+        if (queuedIt == newCommandIt)
+            return;
+
+        // The new command is kept at its position, after the commands queued in the meantime,
+        // but it is executed as urgently as the queued one would have been.
+        const auto urgentFlags = CmdImmediately | CmdInterrupt;
+        const auto queuedUrgentFlags = (*queuedIt)->flags() & urgentFlags;
+        if (queuedUrgentFlags) {
+            // the new command is counted instead of the queued one, unless it is counted already
+            if (command->flags() & urgentFlags)
+                --m_immediatelyCounter;
+            command->setFlags(command->flags() | queuedUrgentFlags);
+        }
+        m_commandList.erase(queuedIt);
     }
 }
 
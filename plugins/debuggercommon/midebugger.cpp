@@ -130,13 +130,27 @@ void MIDebugger::readyReadStandardOutput()
     {
         /* In MI mode, all messages are exactly one line.
            See if we have any complete lines in the buffer. */
-        int i = m_buffer.indexOf('\n');
-        if (i == -1)
+        const auto end = m_buffer.indexOf('\n', m_scanOffset);
+        if (end == -1) {
+            // a long reply arrives in many reads, do not scan its beginning for a newline again
+            m_scanOffset = m_buffer.size();
             break;
-        QByteArray reply(m_buffer.left(i));
-        m_buffer.remove(0, i+1);
+        }
+        const auto begin = m_bufferOffset;
+        m_bufferOffset = m_scanOffset = end + 1;
+
+        // The line is passed without copying it out of the buffer. The shallow copy keeps the data
+        // alive in case a handler of the line reenters this function, which then changes m_buffer.
+        // The parser may look at the byte after the line, which is the terminating newline.
+        const QByteArray buffer = m_buffer;
+        processLine(QByteArray::fromRawData(buffer.constData() + begin, end - begin));
+    }
 
-        processLine(reply);
+    // drop the processed lines once per read instead of once per line
+    if (m_bufferOffset > 0) {
+        m_buffer.remove(0, m_bufferOffset);
+        m_scanOffset -= m_bufferOffset;
+        m_bufferOffset = 0;
     }
 }
 
@@ -131,6 +131,10 @@ protected:
     /** The unprocessed output from debugger. Output is
         processed as soon as we see newline. */
     QByteArray m_buffer;
+    /** The offset of the first unprocessed byte in m_buffer */
+    qsizetype m_bufferOffset = 0;
+    /** The offset in m_buffer up to which the unprocessed output contains no newline */
+    qsizetype m_scanOffset = 0;
 };
 
 }
@@ -100,7 +100,7 @@ public:
         if (!m_variable) return;
         bool hasValue = false;
         MIVariable* variable = m_variable.data();
-        variable->deleteChildren();
+        variable->discardChildren();
         variable->setInScope(true);
         if (r.isReasonError()) {
             variable->setShowError(true);
@@ -173,13 +173,29 @@ public:
     FetchMoreChildrenHandler(MIVariable *variable, MIDebugSession *session)
         : m_variable(variable)
         , m_session(session)
-    {}
+        , m_generation(variable->m_childrenGeneration)
+    {
+        ++variable->m_childFetchesInFlight;
+    }
+
+    ~FetchMoreChildrenHandler() override
+    {
+        // Also reached if the command is dropped from the queue without being executed,
+        // e.g. because the program is resumed.
+        if (m_variable && m_variable->m_childrenGeneration == m_generation) {
+            --m_variable->m_childFetchesInFlight;
+        }
+    }
 
     void handle(const ResultRecord &r) override
     {
         MIVariable* variable = m_variable.data();
         if (!variable)
             return;
+        if (variable->m_childrenGeneration != m_generation) {
+            qCDebug(DEBUGGERCOMMON) << "dropping stale children of" << variable->varobj();
+            return;
+        }
 
         if (r.hasField(QStringLiteral("children")))
         {
@@ -232,11 +248,18 @@ public:
 private:
     QPointer<MIVariable> m_variable;
     MIDebugSession *m_session;
+    const int m_generation;
     bool m_isLastHandler = true;
 };
 
 void MIVariable::fetchMoreChildren()
 {
+    // The view asks again while it shows the last fetched child, the next
+    // window can only be requested once the children fetched so far arrived.
+    if (m_childFetchesInFlight > 0) {
+        return;
+    }
+
     int c = childItems.size();
     // FIXME: should not even try this if app is not started.
     // Probably need to disable open, or something
@@ -254,7 +277,7 @@ void MIVariable::handleUpdate(const Value& var)
     if (var.hasField(QStringLiteral("type_changed"))
         && var[QStringLiteral("type_changed")].literal() == QLatin1String("true"))
     {
-        deleteChildren();
+        discardChildren();
         // FIXME: verify that this check is right.
         setHasMore(var[QStringLiteral("new_num_children")].toInt() != 0);
         fetchMoreChildren();
@@ -299,6 +322,13 @@ void MIVariable::handleUpdate(const Value& var)
     }
 }
 
+void MIVariable::discardChildren()
+{
+    ++m_childrenGeneration;
+    m_childFetchesInFlight = 0;
+    deleteChildren();
+}
+
 const QString& MIVariable::varobj() const
 {
     return m_varobj;
@@ -63,15 +63,27 @@ protected: // Internal
 
     void setVarobj(const QString& v);
 
+    /**
+     * Deletes the children. Replies to requests for children which are still in flight
+     * are dropped, as they refer to the discarded children.
+     */
+    void discardChildren();
+
 protected:
     QPointer<MIDebugSession> m_debugSession;
 
 private:
     QString m_varobj;
 
+    // Incremented when the children are discarded, so that stale replies can be recognized.
+    int m_childrenGeneration = 0;
+    // Requests for children of the current generation which are still in flight.
+    int m_childFetchesInFlight = 0;
+
     // How many children should be fetched in one
-    // increment.
-    static const int s_fetchStep = 5;
+    // increment. The view asks for the next ones
+    // when the last fetched child is scrolled into view.
+    static const int s_fetchStep = 50;
 };
 } // end of KDevMI
 
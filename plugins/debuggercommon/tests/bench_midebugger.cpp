@@ -0,0 +1,126 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "bench_midebugger.h"
+
+#include <midebugger.h>
+
+#include <tests/autotestshell.h>
+#include <tests/testcore.h>
+
+#include <KConfigGroup>
+
+#include <QFile>
+#include <QLoggingCategory>
+#include <QSignalSpy>
+#include <QTest>
+
+using namespace KDevelop;
+using namespace KDevMI;
+
+namespace {
+/// A debugger whose output is the transcript file given as its argument
+class TranscriptDebugger : public MIDebugger
+{
+public:
+    bool start(KConfigGroup&, const QStringList& extraArguments) override
+    {
+        m_debuggerExecutable = QStringLiteral("cat");
+        m_process->setProgram(m_debuggerExecutable, extraArguments);
+        m_process->start();
+        return m_process->waitForStarted();
+    }
+};
+
+bool writeTranscript(const QString& fileName, const QByteArray& transcript)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::WriteOnly) && file.write(transcript) == transcript.size();
+}
+}
+
+void BenchMIDebugger::initTestCase()
+{
+    AutoTestShell::init({{}}); // do not load plugins at all
+    TestCore::initialize(Core::NoUi);
+    // MIDebugger logs every line it reads
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false\ndefault.debug=true\n"));
+
+    QVERIFY(m_transcriptDir.isValid());
+}
+
+void BenchMIDebugger::cleanupTestCase()
+{
+    TestCore::shutdown();
+}
+
+void BenchMIDebugger::benchReadTranscript_data()
+{
+    QTest::addColumn<QString>("transcript");
+    QTest::addColumn<int>("records");
+
+    // the libraries loaded when a large application starts
+    QByteArray notifications;
+    for (int i = 0; i < 20000; ++i) {
+        const QByteArray library = "\"/usr/lib/libmodule" + QByteArray::number(i) + ".so\"";
+        notifications += "=library-loaded,id=" + library + ",target-name=" + library + ",host-name=" + library
+            + ",symbols-loaded=\"0\",thread-group=\"i1\",ranges=[{from=\"0x00007ffff7fc5090\",to=\"0x00007ffff7fee315\"}]\n";
+    }
+    const QString notificationsFile = m_transcriptDir.filePath(QStringLiteral("notifications.mi"));
+    QVERIFY(writeTranscript(notificationsFile, notifications));
+    QTest::newRow("notifications") << notificationsFile << 20000;
+
+    // breakpoints in templates with many instantiations and long console output,
+    // which arrive in many reads each
+    QByteArray longRecords;
+    for (int breakpoint = 1; breakpoint <= 20; ++breakpoint) {
+        longRecords += "=breakpoint-modified,bkpt={number=\"" + QByteArray::number(breakpoint)
+            + "\",type=\"breakpoint\",disp=\"keep\",enabled=\"y\",addr=\"<MULTIPLE>\",times=\"0\",locations=[";
+        for (int location = 1; location <= 1000; ++location) {
+            if (location > 1) {
+                longRecords += ',';
+            }
+            longRecords += "{number=\"" + QByteArray::number(breakpoint) + '.' + QByteArray::number(location)
+                + "\",enabled=\"y\",addr=\"0x0000555555555149\",func=\"Container<Type"
+                + QByteArray::number(location) + ">::insert()\",file=\"container.h\","
+                  "fullname=\"/home/user/project/container.h\",line=\"42\",thread-groups=[\"i1\"]}";
+        }
+        longRecords += "]}\n(gdb) \n";
+    }
+    for (int output = 0; output < 4; ++output) {
+        longRecords += "~\"" + QByteArray(1024 * 1024, 'x') + "\\n\"\n(gdb) \n";
+    }
+    const QString longRecordsFile = m_transcriptDir.filePath(QStringLiteral("longrecords.mi"));
+    QVERIFY(writeTranscript(longRecordsFile, longRecords));
+    QTest::newRow("long-records") << longRecordsFile << 24;
+}
+
+void BenchMIDebugger::benchReadTranscript()
+{
+    QFETCH(QString, transcript);
+    QFETCH(int, records);
+
+    QBENCHMARK {
+        TranscriptDebugger debugger;
+        int receivedRecords = 0;
+        connect(&debugger, &MIDebugger::notification, this, [&receivedRecords] {
+            ++receivedRecords;
+        });
+        connect(&debugger, &MIDebugger::streamRecord, this, [&receivedRecords] {
+            ++receivedRecords;
+        });
+        QSignalSpy exitedSpy(&debugger, &MIDebugger::exited);
+
+        KConfigGroup config;
+        QVERIFY(debugger.start(config, {transcript}));
+        QVERIFY(exitedSpy.wait(60000));
+        QCOMPARE(receivedRecords, records);
+    }
+}
+
+QTEST_MAIN(BenchMIDebugger)
+
+#include "moc_bench_midebugger.cpp"
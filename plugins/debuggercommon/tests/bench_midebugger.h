@@ -0,0 +1,28 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef KDEV_BENCHMIDEBUGGER_H
+#define KDEV_BENCHMIDEBUGGER_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+/// Replays MI transcripts through the framing and parsing of MIDebugger
+class BenchMIDebugger : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchReadTranscript_data();
+    void benchReadTranscript();
+
+private:
+    QTemporaryDir m_transcriptDir;
+};
+
+#endif
@@ -135,6 +135,61 @@ void TestMICommandQueue::clearQueue()
     QCOMPARE(command2Spy.count(), 1);
 }
 
+void TestMICommandQueue::coalesceVariableUpdates()
+{
+    KDevMI::MI::CommandQueue commandQueue;
+
+    // prepare
+    auto command1 = std::make_unique<TestDummyCommand>(KDevMI::MI::VarUpdate, QStringLiteral("--all-values *"));
+    auto command2 = std::make_unique<TestDummyCommand>(KDevMI::MI::VarUpdate, QStringLiteral("--all-values var1"));
+    auto command3 = std::make_unique<TestDummyCommand>(KDevMI::MI::StackListLocals, QStringLiteral("--simple-values"));
+    auto command4 = std::make_unique<TestDummyCommand>(KDevMI::MI::VarUpdate, QStringLiteral("--all-values *"));
+    auto command5 = std::make_unique<TestDummyCommand>(KDevMI::MI::VarUpdate, QStringLiteral("--all-values *"),
+                                                       KDevMI::MI::CmdImmediately);
+    auto command6 = std::make_unique<TestDummyCommand>(KDevMI::MI::VarUpdate, QStringLiteral("--all-values *"));
+    command6->setFrame(1);
+    auto command7 = std::make_unique<TestDummyCommand>(KDevMI::MI::VarUpdate, QStringLiteral("--all-values *"));
+
+    QSignalSpy command1Spy(command1.get(), &QObject::destroyed);
+    QSignalSpy command4Spy(command4.get(), &QObject::destroyed);
+    QSignalSpy command5Spy(command5.get(), &QObject::destroyed);
+    QSignalSpy command7Spy(command7.get(), &QObject::destroyed);
+    auto* const command2Ptr = command2.get();
+    auto* const command3Ptr = command3.get();
+    auto* const command6Ptr = command6.get();
+    auto* const command7Ptr = command7.get();
+
+    // execute
+    commandQueue.enqueue(std::move(command1));
+    commandQueue.enqueue(std::move(command2));
+    commandQueue.enqueue(std::move(command3));
+    // the new update replaces the queued one
+    commandQueue.enqueue(std::move(command4));
+    QCOMPARE(command1Spy.count(), 1);
+    QCOMPARE(command4Spy.count(), 0);
+    // the immediate update replaces the queued one
+    commandQueue.enqueue(std::move(command5));
+    QCOMPARE(command4Spy.count(), 1);
+    QCOMPARE(commandQueue.haveImmediateCommand(), true);
+    // another frame is updated separately
+    commandQueue.enqueue(std::move(command6));
+    // the new update replaces the queued immediate one, and is executed immediately instead
+    commandQueue.enqueue(std::move(command7));
+    QCOMPARE(command5Spy.count(), 1);
+    QVERIFY(command7Ptr->flags() & KDevMI::MI::CmdImmediately);
+
+    // check
+    QCOMPARE(command7Spy.count(), 0);
+    QCOMPARE(commandQueue.count(), 4);
+    QCOMPARE(commandQueue.haveImmediateCommand(), true);
+    QCOMPARE(commandQueue.nextCommand().get(), command2Ptr);
+    QCOMPARE(commandQueue.nextCommand().get(), command3Ptr);
+    QCOMPARE(commandQueue.nextCommand().get(), command6Ptr);
+    QCOMPARE(commandQueue.haveImmediateCommand(), true);
+    QCOMPARE(commandQueue.nextCommand().get(), command7Ptr);
+    QCOMPARE(commandQueue.haveImmediateCommand(), false);
+}
+
 QTEST_GUILESS_MAIN(TestMICommandQueue)
 
 #include "test_micommandqueue.moc"
@@ -20,6 +20,7 @@ private Q_SLOTS:
     void addAndTake_data();
     void addAndTake();
     void clearQueue();
+    void coalesceVariableUpdates();
 };
 
 #endif
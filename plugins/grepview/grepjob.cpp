@@ -11,21 +11,30 @@
 #include "grepjob.h"
 #include "grepfindthread.h"
 #include "grepoutputmodel.h"
+#include "greptrigramindex.h"
 #include "greputil.h"
 
 #include "debug.h"
 
 #include <QDebug>
 #include <QFile>
-#include <QTextStream>
+#include <QStringDecoder>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
 
-#include <KEncodingProber>
 #include <KLocalizedString>
 
 #include <serialization/indexedstring.h>
 #include <interfaces/icore.h>
 #include <interfaces/iuicontroller.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <optional>
+
 using namespace KDevelop;
 
 QDebug operator<<(QDebug debug, const GrepJobSettings& s)
@@ -68,6 +77,64 @@ QDebug operator<<(QDebug debug, const GrepJobSettings& s)
     return debug;
 }
 
+namespace {
+/// How often the matches found by the search threads are passed on to the output model
+constexpr int resultInterval = 50;
+
+/// Files that contain a null byte in this many first bytes are considered binary and not searched
+constexpr qsizetype binaryCheckSize = 8192;
+
+bool isAscii(QStringView text)
+{
+    return std::all_of(text.begin(), text.end(), [](QChar c) {
+        return c.unicode() < 0x80;
+    });
+}
+
+char asciiToLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+/// @return whether @p data may contain the ASCII text @p literal, false only if it cannot
+bool containsAscii(QByteArrayView data, const QByteArray& literal, Qt::CaseSensitivity cs)
+{
+    if (cs == Qt::CaseSensitive) {
+        return data.indexOf(literal) != -1;
+    }
+    const auto hash = [](char c) {
+        return std::hash<char>{}(asciiToLower(c));
+    };
+    const auto equal = [](char a, char b) {
+        return asciiToLower(a) == asciiToLower(b);
+    };
+    const auto contains = [&](QByteArrayView part) {
+        const std::boyer_moore_horspool_searcher searcher(part.begin(), part.end(), hash, equal);
+        return std::search(data.begin(), data.end(), searcher) != data.end();
+    };
+
+    // KELVIN SIGN and LATIN SMALL LETTER LONG S are case-insensitively equal to 'k' and 's',
+    // so only the parts of the literal between these letters are certainly found as ASCII
+    qsizetype partStart = 0;
+    for (qsizetype i = 0; i <= literal.size(); ++i) {
+        if (i < literal.size() && asciiToLower(literal[i]) != 'k' && asciiToLower(literal[i]) != 's') {
+            continue;
+        }
+        if (i > partStart && !contains(QByteArrayView(literal).sliced(partStart, i - partStart))) {
+            return false;
+        }
+        partStart = i + 1;
+    }
+    return true;
+}
+
+bool isWideEncoding(QByteArrayView name)
+{
+    return name.startsWith("UTF-16") || name.startsWith("UTF-32") || name.startsWith("utf-16")
+        || name.startsWith("utf-32");
+}
+}
+
 GrepOutputItem::List grepFile(const QString &filename, const QRegExp &re)
 {
     GrepOutputItem::List res;
@@ -75,61 +142,130 @@ GrepOutputItem::List grepFile(const QString &filename, const QRegExp &re)
 
     if(!file.open(QIODevice::ReadOnly))
         return res;
-    int lineno = 0;
 
-    // detect encoding (unicode files can be fed forever, so stop when confidence reaches 99%)
-    KEncodingProber prober;
-    while(!file.atEnd() && prober.state() == KEncodingProber::Probing && prober.confidence() < 0.99) {
-        prober.feed(file.read(0xFF));
+    // map the file instead of copying it, most files do not match at all and are only looked at once
+    QByteArray readData;
+    QByteArrayView data;
+    const qint64 size = file.size();
+    if (const uchar* const mapped = size > 0 ? file.map(0, size) : nullptr) {
+        data = QByteArrayView(mapped, size);
+    } else {
+        readData = file.readAll();
+        data = readData;
     }
 
-    // reads file with detected encoding
-    file.seek(0);
-    // TODO: consider using QIODevice::readLine() and QStringDecoder in place of QTextStream.
-    // The reason is the following paragraph in the documentation of QStringConverter::encodingForName():
-    //      If the name is not the name of a codec listed in the Encoding enumeration, std::nullopt
-    //      is returned. Such a name may, none the less, be accepted by the QStringConverter
-    //      constructor when Qt is built with ICU, if ICU provides a converter with the given name.
-    // The code inside the following `if` block replaced the line `stream.setCodec(prober.encoding().constData());`
-    // during porting from Qt 5 to Qt 6. The function QTextStream::setCodec(const char *codecName)
-    // removed in Qt 6 had probably supported ICU codec names.
-    QTextStream stream(&file);
-    if (prober.confidence() > 0.7) {
-        const auto encoding = QStringConverter::encodingForName(prober.encoding().constData());
-        if (encoding) {
-            stream.setEncoding(*encoding);
-        }
+    const auto literal = literalPattern(re);
+    if (data.isEmpty() || (literal && literal->isEmpty())) {
+        // an empty pattern only matches empty strings, which are never reported
+        return res;
     }
-    while( !stream.atEnd() )
-    {
-        QString data = stream.readLine();
+
+    const auto bomEncoding = QStringConverter::encodingForData(data);
+    const bool hasWideBom = bomEncoding && *bomEncoding != QStringConverter::Utf8;
+    if (!hasWideBom && std::memchr(data.data(), '\0', std::min(data.size(), binaryCheckSize))) {
+        return res; // binary file
+    }
+
+    const QByteArray encoding = detectEncoding(data);
+
+    // quickly skip the files that cannot contain the searched text without decoding them
+    if (literal && isAscii(*literal) && !isWideEncoding(encoding)
+        && !containsAscii(data, literal->toLatin1(), re.caseSensitivity())) {
+        return res;
+    }
+
+    QStringDecoder decoder;
+    if (!encoding.isEmpty()) {
+        decoder = QStringDecoder(encoding.constData());
+    }
+    if (!decoder.isValid()) {
+        decoder = QStringDecoder(QStringConverter::Utf8);
+    }
+    const QString text = decoder.decode(data);
+    file.close();
+
+    const IndexedString indexedFilename(filename);
+    const auto addMatch = [&](int lineno, int start, int end, const QString& line) {
+        DocumentChangePointer change = DocumentChangePointer(new DocumentChange(
+            indexedFilename, KTextEditor::Range(lineno, start, lineno, end), line.mid(start, end - start), QString()));
+        res << GrepOutputItem(change, line, false);
+    };
+
+    int lineno = 0;
+    for (qsizetype lineStart = 0; lineStart < text.size(); ++lineno) {
+        qsizetype lineEnd = text.indexOf(QLatin1Char('\n'), lineStart);
+        if (lineEnd == -1) {
+            lineEnd = text.size();
+        }
+        QStringView line = QStringView(text).sliced(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
 
         // remove line terminators (in order to not match them)
-        for (int pos = data.length()-1; pos >= 0 && (data[pos] == QLatin1Char('\r') || data[pos] == QLatin1Char('\n')); pos--) {
-            data.chop(1);
+        while (line.endsWith(QLatin1Char('\r'))) {
+            line.chop(1);
+        }
+
+        if (literal) {
+            // no need for the regular expression engine, and the line is only copied when it matches
+            QString lineText;
+            for (qsizetype start = line.indexOf(*literal, 0, re.caseSensitivity()); start != -1;
+                 start = line.indexOf(*literal, start + literal->size(), re.caseSensitivity())) {
+                if (lineText.isNull()) {
+                    lineText = line.toString();
+                }
+                addMatch(lineno, start, start + literal->size(), lineText);
+            }
+            continue;
         }
 
+        const QString lineText = line.toString();
         int offset = 0;
         // allow empty string matching result in an infinite loop !
-        while( re.indexIn(data, offset)!=-1 && re.cap(0).length() > 0 )
+        while( re.indexIn(lineText, offset)!=-1 && re.cap(0).length() > 0 )
         {
             int start = re.pos(0);
             int end = start + re.cap(0).length();
-
-            DocumentChangePointer change = DocumentChangePointer(new DocumentChange(
-                IndexedString(filename),
-                KTextEditor::Range(lineno, start, lineno, end),
-                re.cap(0), QString()));
-
-            res << GrepOutputItem(change, data, false);
+            addMatch(lineno, start, end, lineText);
             offset = end;
         }
-        lineno++;
     }
-    file.close();
     return res;
 }
 
+/// The state shared by a GrepJob and the threads that search the files for it
+class GrepSearch
+{
+public:
+    GrepSearch(const QList<QUrl>& files, const QRegExp& regExp)
+        : files(files)
+        , regExp(regExp)
+        , results(files.size())
+        , searched(new std::atomic<bool>[files.size()])
+    {
+        for (int i = 0; i < files.size(); ++i) {
+            searched[i].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /// Searches the files not taken by another thread yet
+    void run(const QRegExp& threadRegExp)
+    {
+        for (int i = nextFileIndex++; i < files.size() && !aborted.load(std::memory_order_relaxed);
+             i = nextFileIndex++) {
+            results[i] = grepFile(files[i].toLocalFile(), threadRegExp);
+            searched[i].store(true, std::memory_order_release);
+        }
+    }
+
+    const QList<QUrl> files;
+    const QRegExp regExp;
+    /// The matches in each file, valid once the file is marked as searched
+    QVector<GrepOutputItem::List> results;
+    const std::unique_ptr<std::atomic<bool>[]> searched;
+    std::atomic<int> nextFileIndex{0};
+    std::atomic<bool> aborted{false};
+};
+
 GrepJob::GrepJob( QObject* parent )
     : KJob( parent )
     , m_workState(WorkUnstarted)
@@ -206,6 +342,15 @@ void GrepJob::slotFindFinished()
         m_outputModel->setReplacementTemplate(m_settings.replacementTemplate);
     }
 
+    if (const auto literal = literalPattern(m_regExp)) {
+        // every index keeps the files it does not know
+        for (const auto& index : std::as_const(m_trigramIndexes)) {
+            if (index) {
+                m_fileList = index->candidates(m_fileList, *literal, m_regExp.caseSensitivity());
+            }
+        }
+    }
+
     emit showMessage(this, i18np("Searching for <b>%2</b> in one file",
                                  "Searching for <b>%2</b> in %1 files",
                                  m_fileList.length(),
@@ -237,22 +382,14 @@ void GrepJob::slotWork()
             m_findThread->start();
             break;
         case WorkGrep:
+            if (!m_search) {
+                startSearch();
+            }
+            collectResults();
             if(m_fileIndex < m_fileList.length())
             {
                 emit showProgress(this, 0, m_fileList.length(), m_fileIndex);
-                if(m_fileIndex < m_fileList.length()) {
-                    QString file = m_fileList[m_fileIndex].toLocalFile();
-                    GrepOutputItem::List items = grepFile(file, m_regExp);
-
-                    if(!items.isEmpty())
-                    {
-                        m_findSomething = true;
-                        emit foundMatches(file, items);
-                    }
-
-                    m_fileIndex++;
-                }
-                QMetaObject::invokeMethod(this, "slotWork", Qt::QueuedConnection);
+                QTimer::singleShot(resultInterval, this, &GrepJob::slotWork);
             }
             else
             {
@@ -265,8 +402,39 @@ void GrepJob::slotWork()
     }
 }
 
+void GrepJob::startSearch()
+{
+    m_search = std::make_shared<GrepSearch>(m_fileList, m_regExp);
+
+    const int threadCount = std::min<int>(QThread::idealThreadCount(), m_fileList.size());
+    for (int i = 0; i < threadCount; ++i) {
+        // QRegExp keeps its match state in the object, so every thread needs its own copy
+        QThreadPool::globalInstance()->start([search = m_search, regExp = m_regExp] {
+            search->run(regExp);
+        });
+    }
+}
+
+void GrepJob::collectResults()
+{
+    // pass on the matches in the order of the files, as far as the files have been searched
+    for (; m_fileIndex < m_fileList.length() && m_search->searched[m_fileIndex].load(std::memory_order_acquire);
+         ++m_fileIndex) {
+        GrepOutputItem::List items = std::move(m_search->results[m_fileIndex]);
+        if(!items.isEmpty())
+        {
+            m_findSomething = true;
+            emit foundMatches(m_fileList[m_fileIndex].toLocalFile(), items);
+        }
+    }
+}
+
 void GrepJob::die()
 {
+    if (m_search) {
+        m_search->aborted = true;
+        m_search.reset();
+    }
     emit hideProgress(this);
     emit clearMessage(this);
     m_workState = WorkDead;
@@ -308,6 +476,9 @@ bool GrepJob::doKill()
             Q_ASSERT(m_workState == WorkCollectFiles);
             m_findThread->tryAbort();
         }
+        if (m_search) {
+            m_search->aborted = true;
+        }
         m_workState = WorkCancelled;
     }
     // Do not let KJob finish immediately if the state was neither Unstarted nor Dead:
@@ -340,6 +511,14 @@ void GrepJob::setDirectoryChoice(const QList<QUrl>& choice)
     m_directoryChoice = choice;
 }
 
+void GrepJob::setTrigramIndexes(const QList<GrepTrigramIndex*>& indexes)
+{
+    m_trigramIndexes.clear();
+    for (auto* index : indexes) {
+        m_trigramIndexes << index;
+    }
+}
+
 void GrepJob::setSettings(const GrepJobSettings& settings)
 {
     m_settings = settings;
@@ -22,14 +22,19 @@
 
 #include "grepoutputmodel.h"
 
+#include <memory>
+
 namespace KDevelop
 {
     class IProject;
 }
 
 class GrepFindFilesThread;
+class GrepSearch;
+class GrepTrigramIndex;
 class GrepViewPlugin;
 class FindReplaceTest; //FIXME: this is useful only for tests
+class BenchGrepJob; //FIXME: this is useful only for benchmarks
 
 class QDebug;
 
@@ -62,6 +67,7 @@ class GrepJob : public KJob, public KDevelop::IStatus
 
     friend class GrepViewPlugin;
     friend class FindReplaceTest;
+    friend class BenchGrepJob;
 
 private:
     ///Job can only be instantiated by plugin
@@ -75,6 +81,8 @@ public:
 
     void setOutputModel(GrepOutputModel * model);
     void setDirectoryChoice(const QList<QUrl> &choice);
+    /// Sets the indexes used to skip the files that cannot contain a plain text pattern
+    void setTrigramIndexes(const QList<GrepTrigramIndex*>& indexes);
 
     void start() override;
 
@@ -96,10 +104,13 @@ Q_SIGNALS:
 
 private:
     Q_INVOKABLE void slotWork();
+    void startSearch();
+    void collectResults();
     void die();
     void dieAfterCancellation();
 
     QList<QUrl> m_directoryChoice;
+    QList<QPointer<GrepTrigramIndex>> m_trigramIndexes;
     QString m_errorMessage;
 
     QRegExp m_regExp;
@@ -116,8 +127,11 @@ private:
     } m_workState;
 
     QList<QUrl> m_fileList;
+    /// index of the next file whose matches are to be emitted
     int m_fileIndex;
     GrepFindFilesThread* m_findThread;
+    /// the files are searched in parallel while this is set
+    std::shared_ptr<GrepSearch> m_search;
 
     GrepJobSettings m_settings;
 
@@ -16,18 +16,185 @@
 
 #include <interfaces/icore.h>
 #include <interfaces/idocumentcontroller.h>
+#include <interfaces/ilanguagecontroller.h>
 #include <interfaces/iprojectcontroller.h>
+#include <language/backgroundparser/backgroundparser.h>
+#include <language/editor/modificationrevision.h>
+#include <language/editor/modificationrevisionset.h>
+#include <util/shellutils.h>
 
 #include <KTextEditor/Cursor>
 #include <KTextEditor/Document>
 #include <KLocalizedString>
 
 #include <QDataStream>
+#include <QFile>
 #include <QFontDatabase>
 #include <QModelIndex>
+#include <QSaveFile>
+#include <QStringDecoder>
+#include <QStringEncoder>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <vector>
 
 using namespace KDevelop;
 
+namespace {
+/// How often the files written by the replacement threads are processed
+constexpr int replacementInterval = 50;
+
+/// A replacement in a file on disk, copied from its DocumentChange for the replacement threads
+struct FileChange
+{
+    KTextEditor::Range range;
+    QString oldText;
+    QString newText;
+};
+
+struct FileReplacementResult
+{
+    bool success = false;
+    /// The index of the change whose old text was not found in the file, if any
+    int inconsistentChange = -1;
+};
+
+/// Applies @p changes, which are sorted by their position, to the file @p path in one go.
+/// The file is not written if any of the changes does not match its contents.
+FileReplacementResult replaceInFile(const QString& path, const QVector<FileChange>& changes)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    const QByteArray data = file.readAll();
+    file.close();
+
+    // use the same encoding as the search did
+    const QByteArray encoding = detectEncoding(data);
+    const bool hasBom = QStringConverter::encodingForData(data).has_value();
+    QStringDecoder decoder;
+    QStringEncoder encoder;
+    if (!encoding.isEmpty()) {
+        decoder = QStringDecoder(encoding.constData());
+        encoder = QStringEncoder(encoding.constData(), hasBom ? QStringConverter::Flag::WriteBom
+                                                              : QStringConverter::Flag::Default);
+    }
+    if (!decoder.isValid() || !encoder.isValid()) {
+        decoder = QStringDecoder(QStringConverter::Utf8);
+        encoder = QStringEncoder(QStringConverter::Utf8, hasBom ? QStringConverter::Flag::WriteBom
+                                                                : QStringConverter::Flag::Default);
+    }
+    const QString text = decoder.decode(data);
+    if (decoder.hasError()) {
+        // writing the text back would replace the undecodable bytes
+        return {};
+    }
+
+    QVector<qsizetype> lineStarts{0};
+    for (qsizetype pos = text.indexOf(QLatin1Char('\n')); pos != -1; pos = text.indexOf(QLatin1Char('\n'), pos + 1)) {
+        lineStarts << pos + 1;
+    }
+    // @return the offset of @p cursor in the text, or -1 if the cursor is outside of it
+    const auto offset = [&](const KTextEditor::Cursor& cursor) -> qsizetype {
+        if (cursor.line() < 0 || cursor.line() >= lineStarts.size() || cursor.column() < 0) {
+            return -1;
+        }
+        const qsizetype lineStart = lineStarts[cursor.line()];
+        const qsizetype lineEnd =
+            cursor.line() + 1 < lineStarts.size() ? lineStarts[cursor.line() + 1] - 1 : text.size();
+        return cursor.column() <= lineEnd - lineStart ? lineStart + cursor.column() : -1;
+    };
+
+    QString newText;
+    newText.reserve(text.size());
+    qsizetype copied = 0;
+    for (int i = 0; i < changes.size(); ++i) {
+        const FileChange& change = changes[i];
+        const qsizetype start = offset(change.range.start());
+        const qsizetype end = offset(change.range.end());
+        if (start < copied || end < start || QStringView(text).sliced(start, end - start) != change.oldText) {
+            return {false, i};
+        }
+        newText += QStringView(text).sliced(copied, start - copied);
+        newText += change.newText;
+        copied = end;
+    }
+    newText += QStringView(text).sliced(copied);
+
+    const QByteArray newData = encoder.encode(newText);
+    if (encoder.hasError()) {
+        return {};
+    }
+    QSaveFile saveFile(path);
+    saveFile.setDirectWriteFallback(true);
+    if (!saveFile.open(QIODevice::WriteOnly) || saveFile.write(newData) != newData.size() || !saveFile.commit()) {
+        return {};
+    }
+    return {true};
+}
+}
+
+/// The state shared by a GrepOutputModel and the threads that write its replacements
+/// to the files which are not open in an editor
+class GrepReplacement
+{
+public:
+    struct File
+    {
+        IndexedString document;
+        QString path;
+        QVector<FileChange> changes;
+        /// The changes the above are copied from, only to be used in the main thread
+        QVector<DocumentChangePointer> documentChanges;
+    };
+
+    explicit GrepReplacement(QVector<File>&& files)
+        : files(std::move(files))
+        , results(this->files.size())
+        , replaced(new std::atomic<bool>[this->files.size()])
+    {
+        for (int i = 0; i < this->files.size(); ++i) {
+            replaced[i].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /// Writes the files not taken by another thread yet
+    void run()
+    {
+        for (int i = nextFileIndex++; i < files.size() && !aborted.load(std::memory_order_relaxed);
+             i = nextFileIndex++) {
+            results[i] = replaceInFile(files[i].path, files[i].changes);
+            replaced[i].store(true, std::memory_order_release);
+        }
+    }
+
+    const QVector<File> files;
+    std::vector<FileReplacementResult> results;
+    const std::unique_ptr<std::atomic<bool>[]> replaced;
+    std::atomic<int> nextFileIndex = 0;
+    std::atomic<bool> aborted = false;
+
+    // only used in the main thread
+    int collectedCount = 0;
+    QString failureMessage;
+};
+
+namespace {
+QString replacementFailureMessage(const DocumentChangePointer& change)
+{
+    return i18nc("%1 is the old text, %2 is the new text, %3 is the file path, %4 and %5 are its row and column",
+                 "Failed to replace <b>%1</b> by <b>%2</b> in %3:%4:%5", change->m_oldText.toHtmlEscaped(),
+                 change->m_newText.toHtmlEscaped(), change->m_document.toUrl().toLocalFile(),
+                 change->m_range.start().line() + 1, change->m_range.start().column() + 1);
+}
+}
+
 GrepOutputItem::GrepOutputItem(const DocumentChangePointer& change, const QString &text, bool checkable)
     : QStandardItem(), m_change(change)
 {
@@ -190,7 +357,11 @@ GrepOutputModel::GrepOutputModel( QObject *parent )
 }
 
 GrepOutputModel::~GrepOutputModel()
-{}
+{
+    if (m_replacement) {
+        m_replacement->aborted = true;
+    }
+}
 
 void GrepOutputModel::clear()
 {
@@ -361,6 +532,11 @@ bool GrepOutputModel::itemsCheckable() const
     return m_itemsCheckable;
 }
 
+bool GrepOutputModel::isReplacing() const
+{
+    return static_cast<bool>(m_replacement);
+}
+
 void GrepOutputModel::makeItemsCheckable(bool checkable)
 {
     if(m_itemsCheckable == checkable)
@@ -441,14 +617,22 @@ void GrepOutputModel::updateCheckState(QStandardItem* item)
 void GrepOutputModel::doReplacements()
 {
     Q_ASSERT(m_rootItem);
-    if (!m_rootItem)
+    if (!m_rootItem || m_replacement)
         return; // nothing to do, abort
 
+    // Documents open in an editor are changed there, all other files are rewritten by threads, one
+    // file at a time, without loading them as documents.
+    auto* const documentController = ICore::self()->documentController();
     DocumentChangeSet changeSet;
     changeSet.setFormatPolicy(DocumentChangeSet::NoAutoFormat);
+    bool hasDocumentChanges = false;
+    QVector<GrepReplacement::File> files;
+    QList<QUrl> urls;
+    QVector<GrepOutputItem*> replacedItems;
     for(int fileRow = 0; fileRow < m_rootItem->rowCount(); fileRow++)
     {
         auto *file = static_cast<GrepOutputItem *>(m_rootItem->child(fileRow));
+        std::optional<bool> isOpen;
         
         for(int matchRow = 0; matchRow < file->rowCount(); matchRow++)
         {
@@ -458,23 +642,104 @@ void GrepOutputModel::doReplacements()
                 DocumentChangePointer change = match->change();
                 // setting replacement text based on current replace value
                 change->m_newText = replacementFor(change->m_oldText);
-                changeSet.addChange(change);
-                // this item cannot be checked anymore
-                match->setCheckState(Qt::Unchecked);
-                match->setEnabled(false);
+                replacedItems << match;
+
+                if (!isOpen) {
+                    const QUrl url = change->m_document.toUrl();
+                    urls << url;
+                    const auto* const document = documentController->documentForUrl(url);
+                    isOpen = document && document->textDocument();
+                    if (!*isOpen) {
+                        files.append({change->m_document, url.toLocalFile(), {}, {}});
+                    }
+                }
+                if (*isOpen) {
+                    changeSet.addChange(change);
+                    hasDocumentChanges = true;
+                } else {
+                    files.last().documentChanges << change;
+                }
             }
         }
     }
-    
-    DocumentChangeSet::ChangeResult result = changeSet.applyAllChanges();
-    if(!result.m_success)
-    {
-        DocumentChangePointer ch = result.m_reasonChange;
-        if(ch)
-            emit showErrorMessage(i18nc("%1 is the old text, %2 is the new text, %3 is the file path, %4 and %5 are its row and column",
-                                        "Failed to replace <b>%1</b> by <b>%2</b> in %3:%4:%5",
-                                        ch->m_oldText.toHtmlEscaped(), ch->m_newText.toHtmlEscaped(), ch->m_document.toUrl().toLocalFile(),
-                                        ch->m_range.start().line() + 1, ch->m_range.start().column() + 1));
+
+    if (!KDevelop::ensureWritable(urls)) {
+        emit replacementsFinished();
+        emit showErrorMessage(i18n("Some of the files to change are not writable."));
+        return;
+    }
+
+    for (auto* match : std::as_const(replacedItems)) {
+        // this item cannot be checked anymore
+        match->setCheckState(Qt::Unchecked);
+        match->setEnabled(false);
+    }
+
+    for (auto& file : files) {
+        std::stable_sort(file.documentChanges.begin(), file.documentChanges.end(),
+                         [](const DocumentChangePointer& a, const DocumentChangePointer& b) {
+                             return a->m_range.start() < b->m_range.start();
+                         });
+        file.changes.reserve(file.documentChanges.size());
+        for (const auto& change : std::as_const(file.documentChanges)) {
+            file.changes.append({change->m_range, change->m_oldText, change->m_newText});
+        }
+    }
+    const int fileCount = files.size();
+    m_replacement = std::make_shared<GrepReplacement>(std::move(files));
+
+    const int threadCount = std::min(QThread::idealThreadCount(), fileCount);
+    for (int i = 0; i < threadCount; ++i) {
+        QThreadPool::globalInstance()->start([replacement = m_replacement] {
+            replacement->run();
+        });
+    }
+
+    if (hasDocumentChanges) {
+        const DocumentChangeSet::ChangeResult result = changeSet.applyAllChanges();
+        if (!result.m_success && result.m_reasonChange) {
+            m_replacement->failureMessage = replacementFailureMessage(result.m_reasonChange);
+        }
+    }
+
+    emit replacementProgress(0, fileCount);
+    QTimer::singleShot(replacementInterval, this, &GrepOutputModel::collectReplacements);
+}
+
+void GrepOutputModel::collectReplacements()
+{
+    Q_ASSERT(m_replacement);
+    GrepReplacement& replacement = *m_replacement;
+
+    auto* const backgroundParser = ICore::self()->languageController()->backgroundParser();
+    const int fileCount = replacement.files.size();
+    for (; replacement.collectedCount < fileCount
+         && replacement.replaced[replacement.collectedCount].load(std::memory_order_acquire);
+         ++replacement.collectedCount) {
+        const GrepReplacement::File& file = replacement.files[replacement.collectedCount];
+        const FileReplacementResult& result = replacement.results[replacement.collectedCount];
+        if (result.success) {
+            ModificationRevision::clearModificationCache(file.document);
+            backgroundParser->addDocument(file.document);
+        } else if (replacement.failureMessage.isEmpty()) {
+            replacement.failureMessage = result.inconsistentChange == -1
+                ? i18n("Failed to write the replacements to %1", file.path)
+                : replacementFailureMessage(file.documentChanges[result.inconsistentChange]);
+        }
+    }
+    emit replacementProgress(replacement.collectedCount, fileCount);
+
+    if (replacement.collectedCount < fileCount) {
+        QTimer::singleShot(replacementInterval, this, &GrepOutputModel::collectReplacements);
+        return;
+    }
+
+    ModificationRevisionSet::clearCache();
+    const QString failureMessage = replacement.failureMessage;
+    m_replacement.reset();
+    emit replacementsFinished();
+    if (!failureMessage.isEmpty()) {
+        emit showErrorMessage(failureMessage);
     }
 }
 
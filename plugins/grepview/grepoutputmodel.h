@@ -17,7 +17,10 @@
 #include <QRegExp>
 #include <QStandardItemModel>
 
+#include <memory>
+
 class QModelIndex;
+class GrepReplacement;
 
 namespace KDevelop {
     class IStatus;
@@ -92,6 +95,8 @@ public:
 
     void makeItemsCheckable(bool checkable);
     bool itemsCheckable() const;
+    /// Whether the replacements started by doReplacements() are still being written
+    bool isReplacing() const;
     
 public Q_SLOTS:
     void appendOutputs( const QString &filename, const GrepOutputItem::List &lines );
@@ -107,9 +112,15 @@ public Q_SLOTS:
 Q_SIGNALS:
     void showMessage( KDevelop::IStatus*, const QString& message );
     void showErrorMessage(const QString& message);
+    /// Emitted while doReplacements() is writing to the files, @p replacedFiles of @p fileCount are done
+    void replacementProgress(int replacedFiles, int fileCount);
+    /// Emitted when the replacements started by doReplacements() are done
+    void replacementsFinished();
 
 private:    
     void makeItemsCheckable(bool checkable, GrepOutputItem* item);
+    /// Processes the files written by the replacement threads, until all of them are done
+    void collectReplacements();
     
     QRegExp m_regExp;
     QString m_replacement;
@@ -122,6 +133,7 @@ private:
     QString m_savedMessage;
     KDevelop::IStatus *m_savedIStatus;
     bool m_itemsCheckable = false;
+    std::shared_ptr<GrepReplacement> m_replacement;
 
 private Q_SLOTS:
     void updateCheckState(QStandardItem*);
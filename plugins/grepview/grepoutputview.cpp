@@ -231,6 +231,8 @@ GrepOutputModel* GrepOutputView::renewModel(const GrepJobSettings& settings, con
     connect(replacementCombo, &KComboBox::editTextChanged, newModel, &GrepOutputModel::setReplacement);
     connect(newModel, &GrepOutputModel::rowsInserted, this, &GrepOutputView::expandElements);
     connect(newModel, &GrepOutputModel::showErrorMessage, this, &GrepOutputView::showErrorMessage);
+    connect(newModel, &GrepOutputModel::replacementProgress, this, &GrepOutputView::showReplacementProgress);
+    connect(newModel, &GrepOutputModel::replacementsFinished, this, &GrepOutputView::replacementsFinished);
     connect(m_plugin, &GrepViewPlugin::grepJobFinished, this, &GrepOutputView::updateScrollArea);
 
     // appends new model to history
@@ -289,6 +291,8 @@ void GrepOutputView::changeModel(int index)
     updateApplyState(model()->index(0, 0), model()->index(0, 0));
     m_refresh->setEnabled(true);
     m_clearSearchHistory->setEnabled(true);
+    // the model whose replacements disabled the view may have been dropped from the history before they finished
+    setEnabled(index < 0 || !model()->isReplacing());
 }
 
 void GrepOutputView::setMessage(const QString& msg, MessageType type)
@@ -329,9 +333,24 @@ void GrepOutputView::onApply()
             return;
         }
 
+        // enabled again when the replacements are finished
         setEnabled(false);
         model()->doReplacements();
-        setEnabled(true);
+    }
+}
+
+void GrepOutputView::showReplacementProgress(int replacedFiles, int fileCount)
+{
+    setMessage(i18np("Replacing in %2 of 1 file...", "Replacing in %2 of %1 files...", fileCount, replacedFiles),
+               Information);
+}
+
+void GrepOutputView::replacementsFinished()
+{
+    setEnabled(true);
+    if (model()) {
+        // show the status of the search again
+        model()->showMessageEmit();
     }
 }
 
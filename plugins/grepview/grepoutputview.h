@@ -89,6 +89,8 @@ private Q_SLOTS:
     void collapseAllItems();
     void expandAllItems();
     void onApply();
+    void showReplacementProgress(int replacedFiles, int fileCount);
+    void replacementsFinished();
     void showDialog();
     void refresh();
     void expandElements( const QModelIndex & parent );
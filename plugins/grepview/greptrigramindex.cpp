@@ -0,0 +1,705 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "greptrigramindex.h"
+
+#include "debug.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QStringConverter>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+
+#include <KDirWatch>
+
+#include <interfaces/iproject.h>
+#include <project/abstractfilemanagerplugin.h>
+#include <project/projectmodel.h>
+#include <util/path.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <vector>
+
+using namespace KDevelop;
+
+namespace {
+constexpr quint32 cacheVersion = 1;
+
+/// Files that contain a null byte in this many first bytes are binary, GrepJob does not search them
+constexpr qsizetype binaryCheckSize = 8192;
+
+/// How long to wait for more changes before files are indexed again
+constexpr int updateDelay = 1000;
+
+/// Three ASCII characters, 7 bits each
+using Trigram = quint32;
+constexpr int trigramBits = 21;
+
+constexpr uchar foldAscii(uchar c)
+{
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+constexpr bool isIndexed(uchar c)
+{
+    // searches never span lines
+    return c < 0x80 && c != '\n' && c != '\r';
+}
+
+constexpr Trigram trigram(uchar a, uchar b, uchar c)
+{
+    return (Trigram(foldAscii(a)) << 14) | (Trigram(foldAscii(b)) << 7) | foldAscii(c);
+}
+
+struct FileEntry
+{
+    /// empty once the file has been dropped from the index
+    QString path;
+    qint64 size = -1;
+    qint64 lastModified = 0;
+    /// the contents could not be indexed, e.g. because they are encoded in UTF-16
+    bool alwaysCandidate = false;
+};
+
+struct IndexedFile
+{
+    FileEntry entry;
+    std::vector<Trigram> trigrams;
+    bool exists = true;
+};
+
+/// Collects the distinct trigrams of files, reusing its bit set
+class TrigramCollector
+{
+public:
+    TrigramCollector()
+        : m_seen((1u << trigramBits) / 64)
+    {
+    }
+
+    IndexedFile indexFile(const QString& path)
+    {
+        IndexedFile result;
+        result.entry.path = path;
+
+        const QFileInfo info(path);
+        if (!info.isFile()) {
+            result.exists = false;
+            return result;
+        }
+        result.entry.size = info.size();
+        result.entry.lastModified = info.lastModified().toMSecsSinceEpoch();
+
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            result.entry.alwaysCandidate = true;
+            return result;
+        }
+        QByteArray readData;
+        QByteArrayView data;
+        if (const uchar* const mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr) {
+            data = QByteArrayView(mapped, file.size());
+        } else {
+            readData = file.readAll();
+            data = readData;
+        }
+
+        const auto bomEncoding = QStringConverter::encodingForData(data);
+        if (bomEncoding && *bomEncoding != QStringConverter::Utf8) {
+            result.entry.alwaysCandidate = true;
+            return result;
+        }
+        if (std::memchr(data.data(), '\0', std::min(data.size(), binaryCheckSize))) {
+            return result; // binary files never match
+        }
+
+        const auto* const bytes = reinterpret_cast<const uchar*>(data.data());
+        for (qsizetype i = 2; i < data.size(); ++i) {
+            if (!isIndexed(bytes[i])) {
+                i += 2; // the next two windows contain this byte too
+                continue;
+            }
+            if (!isIndexed(bytes[i - 1]) || !isIndexed(bytes[i - 2])) {
+                continue;
+            }
+            const Trigram t = trigram(bytes[i - 2], bytes[i - 1], bytes[i]);
+            quint64& word = m_seen[t / 64];
+            const quint64 bit = quint64(1) << (t % 64);
+            if (!(word & bit)) {
+                word |= bit;
+                result.trigrams.push_back(t);
+            }
+        }
+
+        for (const Trigram t : result.trigrams) {
+            m_seen[t / 64] = 0;
+        }
+        return result;
+    }
+
+private:
+    std::vector<quint64> m_seen;
+};
+
+/// @return the trigrams that every file containing @p literal must contain
+std::vector<Trigram> queryTrigrams(const QString& literal, Qt::CaseSensitivity cs)
+{
+    const auto isQueried = [cs](QChar c) {
+        if (c.unicode() >= 0x80 || !isIndexed(c.unicode())) {
+            return false;
+        }
+        // KELVIN SIGN and LATIN SMALL LETTER LONG S are case-insensitively equal to these ASCII letters
+        const char lower = foldAscii(c.unicode());
+        return cs == Qt::CaseSensitive || (lower != 'k' && lower != 's');
+    };
+
+    std::vector<Trigram> trigrams;
+    for (qsizetype i = 2; i < literal.size(); ++i) {
+        if (isQueried(literal[i - 2]) && isQueried(literal[i - 1]) && isQueried(literal[i])) {
+            trigrams.push_back(trigram(literal[i - 2].unicode(), literal[i - 1].unicode(), literal[i].unicode()));
+        }
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+}
+
+class GrepTrigramIndexPrivate
+{
+public:
+    explicit GrepTrigramIndexPrivate(GrepTrigramIndex* q, const QString& cacheFile)
+        : q(q)
+        , m_cacheFile(cacheFile)
+    {
+        m_updateTimer.setSingleShot(true);
+        m_updateTimer.setInterval(updateDelay);
+        QObject::connect(&m_updateTimer, &QTimer::timeout, q, [this] {
+            startWorker();
+        });
+    }
+
+    void startWorker();
+    /// Queues @p files to be indexed, the ones that are not in the index yet only if @p add is set
+    void queueFiles(const QStringList& files, bool add);
+    /// Runs in the worker thread until there is nothing left to do
+    void work();
+    void load();
+    void save();
+    /// Queues the files whose size or modification time changed since they were indexed
+    void reconcile(const QStringList& files);
+
+    // The following functions must be called with m_mutex locked
+    void addEntry(IndexedFile&& file);
+    void removeEntry(int id);
+    void compact();
+
+    GrepTrigramIndex* const q;
+    const QString m_cacheFile;
+    QTimer m_updateTimer;
+    std::unique_ptr<QThread> m_worker;
+    std::atomic<bool> m_aborted{false};
+
+    mutable QMutex m_mutex;
+    // The following members are guarded by m_mutex
+    /// The indexed files, by id
+    QVector<FileEntry> m_files;
+    QHash<QString, int> m_fileIds;
+    /// The ids of the files that contain each trigram, in ascending order
+    QHash<Trigram, QVector<int>> m_postings;
+    int m_removedCount = 0;
+    /// The files to index, along with the count of their update requests
+    QHash<QString, int> m_pendingFiles;
+    /// The files to reconcile the index with
+    std::optional<QStringList> m_pendingFileSet;
+    bool m_workerRunning = false;
+    bool m_loaded = false;
+    bool m_ready = false;
+};
+
+void GrepTrigramIndexPrivate::startWorker()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_workerRunning) {
+            return; // the running worker picks up the new work
+        }
+        m_workerRunning = true;
+    }
+
+    if (m_worker) {
+        m_worker->wait(); // it has finished its work already
+    }
+    m_worker.reset(QThread::create([this] {
+        work();
+    }));
+    m_worker->start(QThread::LowPriority);
+}
+
+void GrepTrigramIndexPrivate::work()
+{
+    if (!m_loaded) {
+        load();
+    }
+
+    TrigramCollector collector;
+    bool changed = false;
+    bool becameReady = false;
+    while (!m_aborted) {
+        std::optional<QStringList> fileSet;
+        QHash<QString, int> files;
+        {
+            QMutexLocker lock(&m_mutex);
+            fileSet = std::exchange(m_pendingFileSet, std::nullopt);
+            files = m_pendingFiles;
+            if (!fileSet && files.isEmpty()) {
+                if (!m_ready) {
+                    m_ready = true;
+                    becameReady = true;
+                }
+                if (!changed) {
+                    m_workerRunning = false;
+                    break;
+                }
+            }
+        }
+
+        if (fileSet) {
+            reconcile(*fileSet);
+            changed = true;
+            continue;
+        }
+
+        if (files.isEmpty()) {
+            save();
+            changed = false;
+            continue;
+        }
+
+        for (auto it = files.cbegin(), end = files.cend(); it != end && !m_aborted; ++it) {
+            auto indexedFile = collector.indexFile(it.key());
+
+            QMutexLocker lock(&m_mutex);
+            const auto pendingIt = m_pendingFiles.find(it.key());
+            // the file may have been removed, or changed again while it was being indexed
+            if (pendingIt == m_pendingFiles.end() || *pendingIt != it.value()) {
+                continue;
+            }
+            m_pendingFiles.erase(pendingIt);
+            if (indexedFile.exists) {
+                addEntry(std::move(indexedFile));
+            } else if (const int id = m_fileIds.value(it.key(), -1); id != -1) {
+                removeEntry(id);
+            }
+        }
+        changed = true;
+
+        QMutexLocker lock(&m_mutex);
+        if (m_removedCount > 1000 && m_removedCount > m_files.size() / 2) {
+            compact();
+        }
+    }
+
+    if (m_aborted) {
+        QMutexLocker lock(&m_mutex);
+        m_workerRunning = false;
+    } else if (becameReady) {
+        QMetaObject::invokeMethod(q, &GrepTrigramIndex::ready, Qt::QueuedConnection);
+    }
+}
+
+void GrepTrigramIndexPrivate::reconcile(const QStringList& files)
+{
+    QHash<QString, FileEntry> indexed;
+    {
+        QMutexLocker lock(&m_mutex);
+        const QSet<QString> fileSet(files.begin(), files.end());
+        for (int id = 0; id < m_files.size(); ++id) {
+            const auto& entry = m_files[id];
+            if (entry.path.isEmpty()) {
+                continue;
+            }
+            if (fileSet.contains(entry.path)) {
+                indexed.insert(entry.path, entry);
+            } else {
+                removeEntry(id);
+            }
+        }
+    }
+
+    // check the files outside of the lock, there may be many of them
+    QStringList outdated;
+    for (const QString& path : files) {
+        if (m_aborted) {
+            // the index is being destroyed, which waits for this
+            return;
+        }
+        const auto it = indexed.constFind(path);
+        if (it != indexed.cend()) {
+            const QFileInfo info(path);
+            if (info.size() == it->size && info.lastModified().toMSecsSinceEpoch() == it->lastModified) {
+                continue;
+            }
+        }
+        outdated << path;
+    }
+
+    qCDebug(PLUGIN_GREPVIEW) << "trigram index: indexing" << outdated.size() << "of" << files.size() << "files";
+
+    QMutexLocker lock(&m_mutex);
+    for (const QString& path : std::as_const(outdated)) {
+        ++m_pendingFiles[path];
+    }
+}
+
+void GrepTrigramIndexPrivate::addEntry(IndexedFile&& file)
+{
+    if (const int id = m_fileIds.value(file.entry.path, -1); id != -1) {
+        removeEntry(id);
+    }
+
+    const int id = m_files.size();
+    m_fileIds.insert(file.entry.path, id);
+    m_files.append(std::move(file.entry));
+    for (const Trigram t : file.trigrams) {
+        m_postings[t].append(id);
+    }
+}
+
+void GrepTrigramIndexPrivate::removeEntry(int id)
+{
+    // the postings are cleaned up by compact()
+    m_fileIds.remove(m_files[id].path);
+    m_files[id].path.clear();
+    ++m_removedCount;
+}
+
+void GrepTrigramIndexPrivate::compact()
+{
+    QVector<int> newIds(m_files.size(), -1);
+    QVector<FileEntry> files;
+    files.reserve(m_files.size() - m_removedCount);
+    for (int id = 0; id < m_files.size(); ++id) {
+        if (!m_files[id].path.isEmpty()) {
+            newIds[id] = files.size();
+            m_fileIds[m_files[id].path] = files.size();
+            files.append(std::move(m_files[id]));
+        }
+    }
+
+    for (auto it = m_postings.begin(); it != m_postings.end();) {
+        QVector<int> ids;
+        for (const int id : std::as_const(*it)) {
+            if (newIds[id] != -1) {
+                ids.append(newIds[id]);
+            }
+        }
+        if (ids.isEmpty()) {
+            it = m_postings.erase(it);
+        } else {
+            *it = std::move(ids);
+            ++it;
+        }
+    }
+
+    m_files = std::move(files);
+    m_removedCount = 0;
+}
+
+void GrepTrigramIndexPrivate::load()
+{
+    m_loaded = true;
+    if (m_cacheFile.isEmpty()) {
+        return;
+    }
+
+    QFile file(m_cacheFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 version = 0;
+    in >> version;
+    if (version != cacheVersion) {
+        return;
+    }
+
+    QVector<FileEntry> files;
+    quint32 fileCount = 0;
+    in >> fileCount;
+    // every entry takes more than a byte, do not trust the count of a corrupt file
+    files.reserve(std::min<qint64>(fileCount, file.size()));
+    for (quint32 i = 0; i < fileCount && in.status() == QDataStream::Ok; ++i) {
+        FileEntry entry;
+        in >> entry.path >> entry.size >> entry.lastModified >> entry.alwaysCandidate;
+        files.append(std::move(entry));
+    }
+
+    QHash<Trigram, QVector<int>> postings;
+    quint32 trigramCount = 0;
+    in >> trigramCount;
+    postings.reserve(std::min<qint64>(trigramCount, 1 << trigramBits));
+    bool valid = true;
+    for (quint32 i = 0; i < trigramCount && valid && in.status() == QDataStream::Ok; ++i) {
+        Trigram t;
+        QVector<int> ids;
+        in >> t >> ids;
+        // queries look up the ids in the file list and intersect the postings assuming ascending ids
+        int previousId = -1;
+        for (const int id : std::as_const(ids)) {
+            if (id <= previousId || id >= files.size()) {
+                valid = false;
+                break;
+            }
+            previousId = id;
+        }
+        postings.insert(t, std::move(ids));
+    }
+
+    if (!valid || in.status() != QDataStream::Ok) {
+        qCWarning(PLUGIN_GREPVIEW) << "ignoring corrupt trigram index" << m_cacheFile;
+        return;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    m_files = std::move(files);
+    m_fileIds.clear();
+    for (int id = 0; id < m_files.size(); ++id) {
+        m_fileIds.insert(m_files[id].path, id);
+    }
+    m_postings = std::move(postings);
+    m_removedCount = 0;
+}
+
+void GrepTrigramIndexPrivate::save()
+{
+    if (m_cacheFile.isEmpty()) {
+        return;
+    }
+
+    // take shallow copies, so that searches are not blocked while the index is serialized
+    QVector<FileEntry> files;
+    QHash<Trigram, QVector<int>> postings;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_removedCount > 0) {
+            compact();
+        }
+        files = m_files;
+        postings = m_postings;
+    }
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << cacheVersion << quint32(files.size());
+    for (const auto& entry : std::as_const(files)) {
+        out << entry.path << entry.size << entry.lastModified << entry.alwaysCandidate;
+    }
+    out << quint32(postings.size());
+    for (auto it = postings.cbegin(), end = postings.cend(); it != end; ++it) {
+        out << it.key() << it.value();
+    }
+
+    QDir().mkpath(QFileInfo(m_cacheFile).path());
+    QSaveFile file(m_cacheFile);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qCWarning(PLUGIN_GREPVIEW) << "failed to save the trigram index to" << m_cacheFile << file.errorString();
+    }
+}
+
+GrepTrigramIndex::GrepTrigramIndex(const QString& cacheFile, QObject* parent)
+    : QObject(parent)
+    , d_ptr(new GrepTrigramIndexPrivate(this, cacheFile))
+{
+}
+
+GrepTrigramIndex::~GrepTrigramIndex()
+{
+    Q_D(GrepTrigramIndex);
+
+    d->m_aborted = true;
+    if (d->m_worker) {
+        d->m_worker->wait();
+    }
+}
+
+GrepTrigramIndex* GrepTrigramIndex::forProject(IProject* project, QObject* parent)
+{
+    const QByteArray projectHash =
+        QCryptographicHash::hash(project->path().toLocalFile().toUtf8(), QCryptographicHash::Sha1).toHex();
+    const QString cacheFile = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+        + QLatin1String("/grepview/") + QString::fromLatin1(projectHash) + QLatin1String(".trigrams");
+    auto* const index = new GrepTrigramIndex(cacheFile, parent);
+
+    QStringList files;
+    const auto fileSet = project->fileSet();
+    files.reserve(fileSet.size());
+    for (const auto& file : fileSet) {
+        files << file.toUrl().toLocalFile();
+    }
+    index->setFiles(files);
+
+    auto* const fileManager = qobject_cast<AbstractFileManagerPlugin*>(project->managerPlugin());
+    if (!fileManager) {
+        return index;
+    }
+    connect(fileManager, &AbstractFileManagerPlugin::fileAdded, index, [index, project](ProjectFileItem* file) {
+        if (file->project() == project) {
+            index->addFiles({file->path().toLocalFile()});
+        }
+    });
+    connect(fileManager, &AbstractFileManagerPlugin::fileRemoved, index, [index, project](ProjectFileItem* file) {
+        if (file->project() == project) {
+            index->removeFiles({file->path().toLocalFile()});
+        }
+    });
+    connect(fileManager, &AbstractFileManagerPlugin::fileRenamed, index,
+            [index, project](const Path& oldFile, ProjectFileItem* newFile) {
+                if (newFile->project() == project) {
+                    index->removeFiles({oldFile.toLocalFile()});
+                    index->addFiles({newFile->path().toLocalFile()});
+                }
+            });
+    if (auto* const watcher = fileManager->projectWatcher(project)) {
+        // the watcher reports modified files too
+        connect(watcher, &KDirWatch::dirty, index, [index](const QString& path) {
+            index->updateFiles({path});
+        });
+    }
+    return index;
+}
+
+void GrepTrigramIndex::setFiles(const QStringList& files)
+{
+    Q_D(GrepTrigramIndex);
+
+    {
+        QMutexLocker lock(&d->m_mutex);
+        d->m_pendingFileSet = files;
+        d->m_ready = false;
+    }
+    d->startWorker();
+}
+
+void GrepTrigramIndexPrivate::queueFiles(const QStringList& files, bool add)
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        for (const QString& path : files) {
+            // the project watcher reports changes in directories and files outside of the project too
+            if (add || m_fileIds.contains(path) || m_pendingFiles.contains(path)) {
+                ++m_pendingFiles[path];
+            }
+        }
+    }
+    m_updateTimer.start();
+}
+
+void GrepTrigramIndex::addFiles(const QStringList& files)
+{
+    Q_D(GrepTrigramIndex);
+
+    d->queueFiles(files, true);
+}
+
+void GrepTrigramIndex::updateFiles(const QStringList& files)
+{
+    Q_D(GrepTrigramIndex);
+
+    d->queueFiles(files, false);
+}
+
+void GrepTrigramIndex::removeFiles(const QStringList& files)
+{
+    Q_D(GrepTrigramIndex);
+
+    QMutexLocker lock(&d->m_mutex);
+    for (const QString& path : files) {
+        d->m_pendingFiles.remove(path);
+        if (const int id = d->m_fileIds.value(path, -1); id != -1) {
+            d->removeEntry(id);
+        }
+    }
+}
+
+bool GrepTrigramIndex::isReady() const
+{
+    Q_D(const GrepTrigramIndex);
+
+    QMutexLocker lock(&d->m_mutex);
+    return d->m_ready;
+}
+
+QList<QUrl> GrepTrigramIndex::candidates(const QList<QUrl>& files, const QString& literal,
+                                         Qt::CaseSensitivity cs) const
+{
+    Q_D(const GrepTrigramIndex);
+
+    const auto trigrams = queryTrigrams(literal, cs);
+    if (trigrams.empty()) {
+        return files;
+    }
+
+    QMutexLocker lock(&d->m_mutex);
+    if (!d->m_ready) {
+        return files;
+    }
+
+    // intersect the postings, starting with the shortest one
+    std::vector<const QVector<int>*> postings;
+    postings.reserve(trigrams.size());
+    for (const Trigram t : trigrams) {
+        const auto it = d->m_postings.constFind(t);
+        if (it == d->m_postings.cend()) {
+            postings.clear();
+            break;
+        }
+        postings.push_back(&*it);
+    }
+    std::sort(postings.begin(), postings.end(), [](const QVector<int>* a, const QVector<int>* b) {
+        return a->size() < b->size();
+    });
+    QVector<int> matching;
+    if (!postings.empty()) {
+        matching = *postings.front();
+        for (auto it = postings.begin() + 1; it != postings.end() && !matching.isEmpty(); ++it) {
+            QVector<int> intersection;
+            std::set_intersection(matching.cbegin(), matching.cend(), (*it)->cbegin(), (*it)->cend(),
+                                  std::back_inserter(intersection));
+            matching = std::move(intersection);
+        }
+    }
+
+    QList<QUrl> result;
+    for (const QUrl& url : files) {
+        const QString path = url.toLocalFile();
+        const int id = d->m_fileIds.value(path, -1);
+        if (id == -1 || d->m_pendingFiles.contains(path) || d->m_files[id].alwaysCandidate
+            || std::binary_search(matching.cbegin(), matching.cend(), id)) {
+            result << url;
+        }
+    }
+    return result;
+}
+
+#include "moc_greptrigramindex.cpp"
@@ -0,0 +1,83 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef KDEVPLATFORM_PLUGIN_GREPTRIGRAMINDEX_H
+#define KDEVPLATFORM_PLUGIN_GREPTRIGRAMINDEX_H
+
+#include <QList>
+#include <QObject>
+#include <QScopedPointer>
+#include <QStringList>
+#include <QUrl>
+
+namespace KDevelop {
+class IProject;
+}
+
+class GrepTrigramIndexPrivate;
+
+/**
+ * @brief Index of the three-character sequences in a set of files, used to skip the files that
+ *        cannot contain a searched text.
+ *
+ * The index is built in a background thread and saved to a cache file, so that it only needs to
+ * be updated for the files changed in the meantime when it is loaded again. Until the index is
+ * ready, and for files it does not know or that changed since they were indexed, candidates()
+ * conservatively keeps every file.
+ *
+ * Only ASCII characters are indexed, case-insensitively, so the index works for all ASCII-compatible
+ * file encodings. Files in UTF-16 or UTF-32 are always candidates.
+ */
+class GrepTrigramIndex : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @param cacheFile the file the index is loaded from and saved to, no cache is used if it is empty
+     */
+    explicit GrepTrigramIndex(const QString& cacheFile, QObject* parent = nullptr);
+    ~GrepTrigramIndex() override;
+
+    /**
+     * Creates the index of the files in @p project and keeps it current with the changes
+     * reported by the project's file manager.
+     */
+    static GrepTrigramIndex* forProject(KDevelop::IProject* project, QObject* parent = nullptr);
+
+    /**
+     * Sets the files to index. The files indexed before, which are not in @p files, are dropped.
+     */
+    void setFiles(const QStringList& files);
+
+    /// Adds @p files to the index soon, they are candidates for every search until then
+    void addFiles(const QStringList& files);
+
+    /// Indexes @p files again soon, if they are in the index, they are candidates for every search until then
+    void updateFiles(const QStringList& files);
+
+    /// Drops @p files from the index
+    void removeFiles(const QStringList& files);
+
+    /// @return whether the index has been built for the files set last
+    bool isReady() const;
+
+    /**
+     * @return those of @p files that may contain @p literal
+     * @note Files outside of the index are always returned.
+     */
+    QList<QUrl> candidates(const QList<QUrl>& files, const QString& literal, Qt::CaseSensitivity cs) const;
+
+Q_SIGNALS:
+    /// Emitted when the index has been built for the files set last
+    void ready();
+
+private:
+    const QScopedPointer<class GrepTrigramIndexPrivate> d_ptr;
+    Q_DECLARE_PRIVATE(GrepTrigramIndex)
+    friend class GrepTrigramIndexPrivate;
+};
+
+#endif
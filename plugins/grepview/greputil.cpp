@@ -9,9 +9,67 @@
 #include <algorithm>
 #include <QChar>
 #include <QComboBox>
+#include <QRegExp>
+#include <QStringConverter>
+
+#include <KEncodingProber>
 
 static int const MAX_LAST_SEARCH_ITEMS_COUNT = 15;
 
+std::optional<QString> literalPattern(const QRegExp& re)
+{
+    const QString pattern = re.pattern();
+    switch (re.patternSyntax()) {
+    case QRegExp::FixedString:
+        return pattern;
+    case QRegExp::Wildcard:
+    case QRegExp::WildcardUnix:
+        if (pattern == QRegExp::escape(pattern)) {
+            return pattern;
+        }
+        return std::nullopt;
+    case QRegExp::RegExp:
+    case QRegExp::RegExp2:
+        break;
+    default:
+        return std::nullopt;
+    }
+
+    QString literal;
+    literal.reserve(pattern.size());
+    for (qsizetype i = 0; i < pattern.size(); ++i) {
+        const QChar c = pattern[i];
+        if (c == QLatin1Char('\\')) {
+            // escaped letters and digits are character classes, assertions or back references
+            if (i + 1 == pattern.size() || pattern[i + 1].isLetterOrNumber()) {
+                return std::nullopt;
+            }
+            literal += pattern[++i];
+        } else if (QStringView(u"$()*+.?[]^{|}").contains(c)) {
+            return std::nullopt;
+        } else {
+            literal += c;
+        }
+    }
+    return literal;
+}
+
+QByteArray detectEncoding(QByteArrayView data)
+{
+    // a byte order mark takes precedence, as with QTextStream
+    if (const auto bomEncoding = QStringConverter::encodingForData(data)) {
+        return QStringConverter::nameForEncoding(*bomEncoding);
+    }
+
+    // unicode files can be fed forever, so stop when confidence reaches 99%
+    KEncodingProber prober;
+    for (qsizetype pos = 0;
+         pos < data.size() && prober.state() == KEncodingProber::Probing && prober.confidence() < 0.99; pos += 0xFF) {
+        prober.feed(data.sliced(pos, std::min<qsizetype>(0xFF, data.size() - pos)).toByteArray());
+    }
+    return prober.confidence() > 0.7 ? prober.encoding() : QByteArray();
+}
+
 QString substitudePattern(const QString& pattern, const QString& searchString)
 {
     QString subst = searchString;
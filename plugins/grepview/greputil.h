@@ -8,9 +8,13 @@
 #ifndef KDEVPLATFORM_PLUGIN_GREPUTIL_H
 #define KDEVPLATFORM_PLUGIN_GREPUTIL_H
 
+#include <QByteArray>
 #include <QStringList>
 
+#include <optional>
+
 class QComboBox;
+class QRegExp;
 
 /// Returns the contents of a QComboBox as a QStringList
 QStringList qCombo2StringList( QComboBox* combo, bool allowEmpty = false );
@@ -18,4 +22,12 @@ QStringList qCombo2StringList( QComboBox* combo, bool allowEmpty = false );
 /// Replaces each occurrence of "%s" in pattern by searchString (and "%%" by "%")
 QString substitudePattern(const QString& pattern, const QString& searchString);
 
+/// Returns the text which @p re matches verbatim, if its pattern contains no special characters
+/// other than escaped ones, e.g. after a search for plain text
+std::optional<QString> literalPattern(const QRegExp& re);
+
+/// Returns the name of the encoding of the file contents @p data, taken from its byte order mark
+/// or guessed from the contents, or an empty array if it is unknown
+QByteArray detectEncoding(QByteArrayView data);
+
 #endif
@@ -13,6 +13,7 @@
 #include "grepoutputdelegate.h"
 #include "grepjob.h"
 #include "grepoutputview.h"
+#include "greptrigramindex.h"
 #include "debug.h"
 
 #include <QAction>
@@ -21,6 +22,7 @@
 #include <QMimeDatabase>
 
 #include <KActionCollection>
+#include <KConfigGroup>
 #include <KLocalizedString>
 #include <KParts/MainWindow>
 #include <KTextEditor/Document>
@@ -31,6 +33,8 @@
 #include <interfaces/idocument.h>
 #include <interfaces/idocumentcontroller.h>
 #include <interfaces/iproject.h>
+#include <interfaces/iprojectcontroller.h>
+#include <interfaces/isession.h>
 #include <interfaces/contextmenuextension.h>
 #include <project/projectmodel.h>
 #include <util/path.h>
@@ -92,6 +96,20 @@ GrepViewPlugin::GrepViewPlugin(QObject* parent, const KPluginMetaData& metaData,
     new GrepOutputDelegate(this);
     m_factory = new GrepOutputViewFactory(this);
     core()->uiController()->addToolView(i18nc("@title:window", "Find/Replace in Files"), m_factory);
+
+    const auto useTrigramIndex =
+        core()->activeSession()->config()->group(QStringLiteral("GrepDialog")).readEntry("UseTrigramIndex", false);
+    if (useTrigramIndex) {
+        auto* const projectController = core()->projectController();
+        connect(projectController, &KDevelop::IProjectController::projectOpened, this,
+                &GrepViewPlugin::projectOpened);
+        connect(projectController, &KDevelop::IProjectController::projectClosing, this,
+                &GrepViewPlugin::projectClosing);
+        const auto projects = projectController->projects();
+        for (auto* project : projects) {
+            projectOpened(project);
+        }
+    }
 }
 
 GrepOutputViewFactory* GrepViewPlugin::toolViewFactory() const
@@ -103,6 +121,16 @@ GrepViewPlugin::~GrepViewPlugin()
 {
 }
 
+void GrepViewPlugin::projectOpened(KDevelop::IProject* project)
+{
+    m_trigramIndexes.insert(project, GrepTrigramIndex::forProject(project, this));
+}
+
+void GrepViewPlugin::projectClosing(KDevelop::IProject* project)
+{
+    delete m_trigramIndexes.take(project);
+}
+
 void GrepViewPlugin::unload()
 {
     for (const QPointer<GrepDialog>& p : std::as_const(m_currentDialogs)) {
@@ -223,6 +251,7 @@ GrepJob* GrepViewPlugin::newGrepJob()
         m_currentJob->kill();
     }
     m_currentJob = new GrepJob();
+    m_currentJob->setTrigramIndexes(m_trigramIndexes.values());
     connect(m_currentJob, &GrepJob::finished, this, &GrepViewPlugin::jobFinished);
     return m_currentJob;
 }
@@ -10,6 +10,7 @@
 
 #include <interfaces/iplugin.h>
 
+#include <QHash>
 #include <QVector>
 #include <QPointer>
 #include <QVariant>
@@ -18,6 +19,11 @@ class KJob;
 class GrepDialog;
 class GrepJob;
 class GrepOutputViewFactory;
+class GrepTrigramIndex;
+
+namespace KDevelop {
+class IProject;
+}
 
 class GrepViewPlugin : public KDevelop::IPlugin
 {
@@ -55,9 +61,13 @@ private Q_SLOTS:
     void showDialogFromMenu();
     void showDialogFromProject();
     void jobFinished(KJob *job);
+    void projectOpened(KDevelop::IProject* project);
+    void projectClosing(KDevelop::IProject* project);
 
 private:
     GrepJob *m_currentJob;
+    /// Trigram indexes of the open projects, if enabled with the UseTrigramIndex entry of the GrepDialog config group
+    QHash<KDevelop::IProject*, GrepTrigramIndex*> m_trigramIndexes;
     QVector<QPointer<GrepDialog>> m_currentDialogs;
     QString m_directory;
     QString m_contextMenuDirectory;
@@ -0,0 +1,211 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QRegExp>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTextStream>
+
+#include <KEncodingProber>
+
+#include <serialization/indexedstring.h>
+#include <tests/autotestshell.h>
+#include <tests/testcore.h>
+
+#include "../grepjob.h"
+#include "../grepoutputmodel.h"
+
+using namespace KDevelop;
+
+namespace {
+const int DirectoryCount = 20;
+const int FilesPerDirectory = 500;
+const int LinesPerFile = 100;
+
+/// The implementation of grepFile() that read every file line by line through QTextStream on the GUI thread
+GrepOutputItem::List textStreamGrepFile(const QString& filename, const QRegExp& re)
+{
+    GrepOutputItem::List res;
+    QFile file(filename);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return res;
+    int lineno = 0;
+
+    KEncodingProber prober;
+    while (!file.atEnd() && prober.state() == KEncodingProber::Probing && prober.confidence() < 0.99) {
+        prober.feed(file.read(0xFF));
+    }
+
+    file.seek(0);
+    QTextStream stream(&file);
+    if (prober.confidence() > 0.7) {
+        const auto encoding = QStringConverter::encodingForName(prober.encoding().constData());
+        if (encoding) {
+            stream.setEncoding(*encoding);
+        }
+    }
+    while (!stream.atEnd()) {
+        QString data = stream.readLine();
+
+        for (int pos = data.length() - 1; pos >= 0 && (data[pos] == QLatin1Char('\r') || data[pos] == QLatin1Char('\n')); pos--) {
+            data.chop(1);
+        }
+
+        int offset = 0;
+        while (re.indexIn(data, offset) != -1 && re.cap(0).length() > 0) {
+            int start = re.pos(0);
+            int end = start + re.cap(0).length();
+
+            DocumentChangePointer change = DocumentChangePointer(new DocumentChange(
+                IndexedString(filename), KTextEditor::Range(lineno, start, lineno, end), re.cap(0), QString()));
+
+            res << GrepOutputItem(change, data, false);
+            offset = end;
+        }
+        lineno++;
+    }
+    return res;
+}
+}
+
+/// Compares the former sequential search with the current one on a tree of 10k files
+class BenchGrepJob : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchTextStreamGrepFile_data();
+    void benchTextStreamGrepFile();
+    void benchGrepFile_data();
+    void benchGrepFile();
+    void benchGrepJob_data();
+    void benchGrepJob();
+
+private:
+    void patternData();
+    void benchmarkSequential(GrepOutputItem::List (*grep)(const QString&, const QRegExp&));
+
+    QTemporaryDir m_fixtureDir;
+    QStringList m_files;
+};
+
+void BenchGrepJob::initTestCase()
+{
+    AutoTestShell::init({{}}); // do not load plugins at all
+    TestCore::initialize(Core::NoUi);
+
+    QVERIFY(m_fixtureDir.isValid());
+    for (int dir = 0; dir < DirectoryCount; ++dir) {
+        const QString dirPath = m_fixtureDir.filePath(QStringLiteral("dir%1").arg(dir));
+        QVERIFY(QDir().mkpath(dirPath));
+        for (int fileIndex = 0; fileIndex < FilesPerDirectory; ++fileIndex) {
+            QFile file(dirPath + QStringLiteral("/file%1.cpp").arg(fileIndex));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            QByteArray contents;
+            for (int line = 0; line < LinesPerFile; ++line) {
+                contents += "    int value" + QByteArray::number(line) + " = compute(argument, "
+                    + QByteArray::number(line * fileIndex) + "); // some comment\n";
+            }
+            // one file in a hundred matches
+            if (fileIndex % 100 == 0) {
+                contents += "    needle_" + QByteArray::number(fileIndex) + "();\n";
+            }
+            file.write(contents);
+            m_files << file.fileName();
+        }
+    }
+}
+
+void BenchGrepJob::cleanupTestCase()
+{
+    TestCore::shutdown();
+}
+
+void BenchGrepJob::patternData()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<bool>("regexp");
+
+    QTest::newRow("literal") << QStringLiteral("needle_") << false;
+    QTest::newRow("regexp") << QStringLiteral("needle_\\d+\\(") << true;
+}
+
+void BenchGrepJob::benchmarkSequential(GrepOutputItem::List (*grep)(const QString&, const QRegExp&))
+{
+    QFETCH(QString, pattern);
+
+    const QRegExp re(pattern);
+    int matchCount = 0;
+    QBENCHMARK {
+        matchCount = 0;
+        for (const QString& file : std::as_const(m_files)) {
+            matchCount += grep(file, re).size();
+        }
+    }
+    QCOMPARE(matchCount, DirectoryCount * FilesPerDirectory / 100);
+}
+
+void BenchGrepJob::benchTextStreamGrepFile_data()
+{
+    patternData();
+}
+
+void BenchGrepJob::benchTextStreamGrepFile()
+{
+    benchmarkSequential(textStreamGrepFile);
+}
+
+void BenchGrepJob::benchGrepFile_data()
+{
+    patternData();
+}
+
+void BenchGrepJob::benchGrepFile()
+{
+    benchmarkSequential(grepFile);
+}
+
+void BenchGrepJob::benchGrepJob_data()
+{
+    patternData();
+}
+
+void BenchGrepJob::benchGrepJob()
+{
+    QFETCH(QString, pattern);
+    QFETCH(bool, regexp);
+
+    GrepJobSettings settings;
+    settings.pattern = pattern;
+    settings.regexp = regexp;
+    settings.searchTemplate = QStringLiteral("%s");
+    settings.replacementTemplate = QStringLiteral("%s");
+    settings.files = QStringLiteral("*");
+
+    QBENCHMARK {
+        GrepJob job;
+        GrepOutputModel model;
+        job.setOutputModel(&model);
+        job.setDirectoryChoice({QUrl::fromLocalFile(m_fixtureDir.path())});
+        job.setSettings(settings);
+        int matchCount = 0;
+        connect(&job, &GrepJob::foundMatches, this, [&matchCount](const QString&, const GrepOutputItem::List& matches) {
+            matchCount += matches.size();
+        });
+        QVERIFY(job.exec());
+        QCOMPARE(matchCount, DirectoryCount * FilesPerDirectory / 100);
+    }
+}
+
+QTEST_MAIN(BenchGrepJob)
+
+#include "bench_grepjob.moc"
@@ -9,11 +9,14 @@
 #include "test_findreplace.h"
 
 #include <QByteArray>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
 #include <QString>
 #include <QStringList>
 #include <QTest>
 #include <QRegExp>
+#include <QSignalSpy>
 
 #include <QTemporaryFile>
 #include <QTemporaryDir>
@@ -27,6 +30,7 @@
 #include "../grepjob.h"
 #include "../grepviewplugin.h"
 #include "../grepoutputmodel.h"
+#include "../greptrigramindex.h"
 
 #include <iterator>
 #include <vector>
@@ -96,6 +100,20 @@ void FindReplaceTest::testFind_data()
                            << (MatchList() << Match(0, 0, 6));
     QTest::newRow("Matching empty string anywhere") << "foobar\n" << QRegExp("")
                            << (MatchList());
+    QTest::newRow("Escaped literal") << "a.b axb\na.b" << QRegExp("a\\.b")
+                           << (MatchList() << Match(0, 0, 3) << Match(1, 0, 3));
+    QTest::newRow("Case insensitive literal") << "Foo fOO\nbar" << QRegExp("foo", Qt::CaseInsensitive)
+                           << (MatchList() << Match(0, 0, 3) << Match(0, 4, 7));
+    QTest::newRow("Literal not found") << "foobar\nbaz" << QRegExp("qux", Qt::CaseInsensitive)
+                           << (MatchList());
+    QTest::newRow("Non-ASCII literal") << QString::fromUtf8("gr\xc3\xbc\xc3\x9fe gr\xc3\xbc\xc3\x9f") << QRegExp(QString::fromUtf8("\xc3\xbc\xc3\x9f"))
+                           << (MatchList() << Match(0, 2, 4) << Match(0, 8, 10));
+    QTest::newRow("Case insensitive literal with KELVIN SIGN") << QString::fromUtf8("\xe2\x84\xaa" "elvin") << QRegExp("kelvin", Qt::CaseInsensitive)
+                           << (MatchList() << Match(0, 0, 6));
+    QTest::newRow("Case insensitive literal with LONG S") << QString::fromUtf8("\xc5\xbf" "un") << QRegExp("sun", Qt::CaseInsensitive)
+                           << (MatchList() << Match(0, 0, 3));
+    QTest::newRow("Binary file") << QString::fromLatin1("foo\0bar", 7) << QRegExp("foo")
+                           << (MatchList());
 }
 
 void FindReplaceTest::testFind()
@@ -400,6 +418,12 @@ void FindReplaceTest::testReplace_data()
         << "f\\w*o" << "%s"
         << "FOO" << "%s"
         << (FileList() << File(QStringLiteral("somefile.txt"), QStringLiteral("FOObar\n FOObar\n fake")));
+
+    QTest::newRow("CRLF line endings")
+        << (FileList() << File(QStringLiteral("somefile.txt"), QStringLiteral("foo\r\nfoo bar foo\r\n")))
+        << "foo" << "%s"
+        << "baz" << "%s"
+        << (FileList() << File(QStringLiteral("somefile.txt"), QStringLiteral("baz\r\nbaz bar baz\r\n")));
 }
 
 
@@ -446,7 +470,9 @@ void FindReplaceTest::testReplace()
     QVERIFY(model->hasResults());
     model->setReplacement(replace);
     model->makeItemsCheckable(true);
+    QSignalSpy finishedSpy(model, &GrepOutputModel::replacementsFinished);
     model->doReplacements();
+    QVERIFY(finishedSpy.wait());
 
     for (const File& fileData : std::as_const(result)) {
         QFile file(dir.filePath(fileData.first));
@@ -457,6 +483,131 @@ void FindReplaceTest::testReplace()
     tempDir.remove();
 }
 
+void FindReplaceTest::testReplaceUndecodable()
+{
+    QTemporaryDir tempDir;
+    QDir dir(tempDir.path());
+
+    // a UTF-8 byte order mark, followed by an invalid UTF-8 byte
+    const QByteArray contents("\xef\xbb\xbf" "foo \xff\n");
+    QFile file(dir.filePath(QStringLiteral("somefile.txt")));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write(contents) == contents.size());
+    file.close();
+
+    auto *job = new GrepJob(this);
+    auto *model = new GrepOutputModel(job);
+    GrepJobSettings settings;
+
+    job->setOutputModel(model);
+    job->setDirectoryChoice(QList<QUrl>() << QUrl::fromLocalFile(dir.path()));
+
+    settings.projectFilesOnly = false;
+    settings.caseSensitive = true;
+    settings.regexp = false;
+    settings.depth = -1; // fully recursive
+    settings.pattern = QStringLiteral("foo");
+    settings.searchTemplate = QStringLiteral("%s");
+    settings.replacementTemplate = QStringLiteral("%s");
+    settings.files = QStringLiteral("*");
+    settings.exclude = QString();
+
+    job->setSettings(settings);
+
+    QVERIFY(job->exec());
+
+    QVERIFY(model->hasResults());
+    model->setReplacement(QStringLiteral("bar"));
+    model->makeItemsCheckable(true);
+    QSignalSpy finishedSpy(model, &GrepOutputModel::replacementsFinished);
+    QSignalSpy errorSpy(model, &GrepOutputModel::showErrorMessage);
+    model->doReplacements();
+    QVERIFY(finishedSpy.wait());
+    QCOMPARE(errorSpy.count(), 1);
+
+    // the file is left untouched instead of losing the invalid byte
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), contents);
+}
+
+void FindReplaceTest::testTrigramIndex()
+{
+    QTemporaryDir tempDir;
+    QDir dir(tempDir.path());
+
+    const FileList files{
+        {QStringLiteral("a.txt"), QStringLiteral("Hello World\n")},
+        {QStringLiteral("b.txt"), QStringLiteral("hello\nworld\n")},
+        {QStringLiteral("c.txt"), QStringLiteral("nothing to see\n")},
+    };
+    QStringList paths;
+    QList<QUrl> urls;
+    for (const File& fileData : files) {
+        QFile file(dir.filePath(fileData.first));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QVERIFY(file.write(fileData.second.toUtf8()) != -1);
+        paths << file.fileName();
+        urls << QUrl::fromLocalFile(file.fileName());
+    }
+    const auto unknownUrl = QUrl::fromLocalFile(dir.filePath(QStringLiteral("unknown.txt")));
+
+    GrepTrigramIndex index(QString{});
+    // everything is a candidate before the index is built
+    QCOMPARE(index.candidates(urls, QStringLiteral("World"), Qt::CaseSensitive), urls);
+
+    QSignalSpy readySpy(&index, &GrepTrigramIndex::ready);
+    index.setFiles(paths);
+    QVERIFY(readySpy.wait());
+    QVERIFY(index.isReady());
+
+    QCOMPARE(index.candidates(urls, QStringLiteral("Hello World"), Qt::CaseSensitive), QList<QUrl>{urls[0]});
+    // the index is case-insensitive, the search itself rejects the wrong case
+    QCOMPARE(index.candidates(urls, QStringLiteral("World"), Qt::CaseSensitive), urls.mid(0, 2));
+    QCOMPARE(index.candidates(urls, QStringLiteral("world"), Qt::CaseInsensitive), urls.mid(0, 2));
+    QCOMPARE(index.candidates(urls, QStringLiteral("missing"), Qt::CaseInsensitive), QList<QUrl>{});
+    // too short to be narrowed down
+    QCOMPARE(index.candidates(urls, QStringLiteral("zz"), Qt::CaseSensitive), urls);
+    QCOMPARE(index.candidates(urls + QList<QUrl>{unknownUrl}, QStringLiteral("missing"), Qt::CaseSensitive),
+             QList<QUrl>{unknownUrl});
+
+    // removed files are unknown to the index again
+    index.removeFiles({paths[0]});
+    QCOMPARE(index.candidates(urls, QStringLiteral("missing"), Qt::CaseSensitive), QList<QUrl>{urls[0]});
+}
+
+void FindReplaceTest::testTrigramIndexCorruptCache()
+{
+    QTemporaryDir tempDir;
+    QDir dir(tempDir.path());
+
+    QFile file(dir.filePath(QStringLiteral("a.txt")));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write("Hello World\n") != -1);
+    file.close();
+    const QFileInfo info(file.fileName());
+    const QList<QUrl> urls{QUrl::fromLocalFile(file.fileName())};
+
+    // an up to date entry for the file, whose postings refer to a file that does not exist
+    QFile cache(dir.filePath(QStringLiteral("index.trigrams")));
+    QVERIFY(cache.open(QIODevice::WriteOnly));
+    QDataStream out(&cache);
+    out.setVersion(QDataStream::Qt_6_0);
+    const quint32 misTrigram = ('m' << 14) | ('i' << 7) | 's';
+    out << quint32(1) << quint32(1) << info.filePath() << info.size()
+        << info.lastModified().toMSecsSinceEpoch() << false;
+    out << quint32(1) << misTrigram << QVector<int>{0, 5};
+    cache.close();
+
+    GrepTrigramIndex index(cache.fileName());
+    QSignalSpy readySpy(&index, &GrepTrigramIndex::ready);
+    index.setFiles({file.fileName()});
+    QVERIFY(readySpy.wait());
+
+    // the cache was discarded and the file indexed again
+    QCOMPARE(index.candidates(urls, QStringLiteral("Hello"), Qt::CaseSensitive), urls);
+    QCOMPARE(index.candidates(urls, QStringLiteral("missing"), Qt::CaseSensitive), QList<QUrl>{});
+}
+
 void FindReplaceTest::addTestProjectFromFileSystem(const QString& path)
 {
     auto* const project = new TestProject(Path{path});
@@ -56,6 +56,10 @@ private Q_SLOTS:
 
     void testReplace();
     void testReplace_data();
+    void testReplaceUndecodable();
+
+    void testTrigramIndex();
+    void testTrigramIndexCorruptCache();
 
 private:
     void addTestProjectFromFileSystem(const QString& path);
@@ -45,7 +45,7 @@ void LldbVariable::refetch()
     // remove all children first, this will cause some gliches in the UI, but there's no good way
     // that we can know if there's anything changed
     if (isExpanded() || !childCount()) {
-        deleteChildren();
+        discardChildren();
         fetchMoreChildren();
     }
 }
@@ -19,6 +19,9 @@
 #include <QThread>
 #include <QTimer>
 
+#include <algorithm>
+#include <utility>
+
 #include <serialization/indexedstring.h>
 
 #include <shell/watcheddocumentset.h>
@@ -30,6 +33,27 @@
 
 using namespace KDevelop;
 
+namespace {
+bool hasForeignProblems(const IndexedString& document, const QVector<IProblem::Ptr>& problems)
+{
+    return std::any_of(problems.begin(), problems.end(), [&document](const IProblem::Ptr& problem) {
+        return problem->finalLocation().document != document;
+    });
+}
+
+/// Adds the documents in which problems of @p document are located to @p locations, other than @p document itself
+void addForeignProblemLocations(const IndexedString& document, const QVector<IProblem::Ptr>& problems,
+                                QSet<IndexedString>& locations)
+{
+    for (const IProblem::Ptr& problem : problems) {
+        const IndexedString& location = problem->finalLocation().document;
+        if (location != document) {
+            locations.insert(location);
+        }
+    }
+}
+}
+
 const int ProblemReporterModel::MinTimeout = 1000;
 const int ProblemReporterModel::MaxTimeout = 5000;
 
@@ -108,7 +132,33 @@ void ProblemReporterModel::timerExpired()
 {
     m_minTimer->stop();
     m_maxTimer->stop();
-    rebuildProblemList();
+
+    // only rebuild the parts of the problem tree that belong to the updated documents
+    const auto updatedDocuments = std::exchange(m_updatedDocuments, {});
+    for (const IndexedString& url : updatedDocuments) {
+        if (!updateDocumentProblems(url)) {
+            rebuildProblemList();
+            return;
+        }
+    }
+}
+
+bool ProblemReporterModel::updateDocumentProblems(const IndexedString& url)
+{
+    // the store replaces problems by their location, so problems located in other
+    // documents would be left behind or duplicated, and problems that other documents
+    // report in this one would be dropped
+    if (m_documentsWithForeignProblems.contains(url) || m_foreignProblemLocations.contains(url)) {
+        return false;
+    }
+
+    const auto documentProblems = problems({url});
+    if (hasForeignProblems(url, documentProblems)) {
+        return false;
+    }
+
+    store()->replaceProblems(url, documentProblems);
+    return true;
 }
 
 void ProblemReporterModel::setCurrentDocument(KDevelop::IDocument* doc)
@@ -131,6 +181,8 @@ void ProblemReporterModel::problemsUpdated(const KDevelop::IndexedString& url)
         !(showImports() && store()->documents()->imports().contains(url)))
         return;
 
+    m_updatedDocuments.insert(url);
+
     /// m_minTimer will expire in MinTimeout unless some other parsing job finishes in this period.
     m_minTimer->start();
     /// m_maxTimer will expire unconditionally in MaxTimeout
@@ -144,10 +196,26 @@ void ProblemReporterModel::rebuildProblemList()
     /// No locking here, because it may be called from an already locked context
     beginResetModel();
 
-    QVector<IProblem::Ptr> allProblems = problems(store()->documents()->get());
+    m_updatedDocuments.clear();
+    m_documentsWithForeignProblems.clear();
+    m_foreignProblemLocations.clear();
+
+    QVector<IProblem::Ptr> allProblems;
+    const auto addProblems = [&](const QSet<IndexedString>& documents) {
+        for (const IndexedString& document : documents) {
+            const auto documentProblems = problems({document});
+            if (hasForeignProblems(document, documentProblems)) {
+                m_documentsWithForeignProblems.insert(document);
+                addForeignProblemLocations(document, documentProblems, m_foreignProblemLocations);
+            }
+            allProblems += documentProblems;
+        }
+    };
+
+    addProblems(store()->documents()->get());
 
     if (showImports())
-        allProblems += problems(store()->documents()->imports());
+        addProblems(store()->documents()->imports());
 
     store()->setProblems(allProblems);
 
@@ -10,6 +10,10 @@
 
 #include <shell/problemmodel.h>
 
+#include <serialization/indexedstring.h>
+
+#include <QSet>
+
 namespace KDevelop
 {
 class IndexedString;
@@ -54,6 +58,15 @@ private Q_SLOTS:
 
 private:
     void rebuildProblemList();
+    /// @return false if the problems of @p url cannot be replaced without a full rebuild
+    bool updateDocumentProblems(const KDevelop::IndexedString& url);
+
+    /// Documents whose problems were updated since the last timeout
+    QSet<KDevelop::IndexedString> m_updatedDocuments;
+    /// Documents that report problems located in other documents
+    QSet<KDevelop::IndexedString> m_documentsWithForeignProblems;
+    /// Documents in which problems reported by other documents are located
+    QSet<KDevelop::IndexedString> m_foreignProblemLocations;
 
     QTimer* m_minTimer;
     QTimer* m_maxTimer;
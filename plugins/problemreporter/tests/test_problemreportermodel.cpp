@@ -0,0 +1,128 @@
+/*
+    SPDX-FileCopyrightText: 2026 the KDevelop Team <kdevelop-devel@kde.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "../problemreportermodel.h"
+
+#include <tests/testcore.h>
+#include <tests/autotestshell.h>
+
+#include <language/duchain/duchain.h>
+#include <language/duchain/duchainlock.h>
+#include <language/duchain/parsingenvironment.h>
+#include <language/duchain/problem.h>
+#include <language/duchain/topducontext.h>
+#include <language/editor/documentrange.h>
+#include <shell/problemstore.h>
+
+#include <algorithm>
+
+using namespace KDevelop;
+
+namespace {
+class TestModel : public ProblemReporterModel
+{
+public:
+    using ProblemReporterModel::ProblemReporterModel;
+    using ProblemModel::store;
+};
+
+ProblemPointer createProblem(const IndexedString& document, const QString& description)
+{
+    ProblemPointer problem(new Problem);
+    problem->setFinalLocation(DocumentRange(document, KTextEditor::Range(0, 0, 0, 1)));
+    problem->setDescription(description);
+    return problem;
+}
+
+TopDUContext* createContext(const IndexedString& document)
+{
+    auto* top = new TopDUContext(document, RangeInRevision(0, 0, 1, 0), new ParsingEnvironmentFile(document));
+    DUChain::self()->addDocumentChain(top);
+    return top;
+}
+
+QStringList descriptions(const QVector<IProblem::Ptr>& problems)
+{
+    QStringList ret;
+    for (const IProblem::Ptr& problem : problems) {
+        ret.append(problem->description());
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+}
+
+class TestProblemReporterModel : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testUpdateDocumentWithForeignProblem();
+};
+
+void TestProblemReporterModel::initTestCase()
+{
+    AutoTestShell::init({{}}); // do not load plugins at all
+    TestCore::initialize(Core::NoUi);
+
+    DUChain::self()->disablePersistentStorage();
+}
+
+void TestProblemReporterModel::cleanupTestCase()
+{
+    TestCore::shutdown();
+}
+
+void TestProblemReporterModel::testUpdateDocumentWithForeignProblem()
+{
+    const IndexedString source(QStringLiteral("/foreign/source.cpp"));
+    const IndexedString header(QStringLiteral("/foreign/header.h"));
+
+    TopDUContext* sourceContext;
+    TopDUContext* headerContext;
+    {
+        DUChainWriteLocker lock;
+        headerContext = createContext(header);
+        headerContext->addProblem(createProblem(header, QStringLiteral("header")));
+        // e.g. an error in a macro expansion, which is reported by the file that expands the macro
+        sourceContext = createContext(source);
+        sourceContext->addImportedParentContext(headerContext);
+        sourceContext->addProblem(createProblem(source, QStringLiteral("source")));
+        sourceContext->addProblem(createProblem(header, QStringLiteral("source in header")));
+    }
+
+    TestModel model(nullptr);
+    model.setScope(CurrentDocument);
+    model.setShowImports(true);
+    model.store()->setCurrentDocument(source);
+    QCOMPARE(descriptions(model.store()->problems(header)),
+             QStringList({QStringLiteral("header"), QStringLiteral("source in header")}));
+
+    {
+        DUChainWriteLocker lock;
+        headerContext->clearProblems();
+        headerContext->addProblem(createProblem(header, QStringLiteral("updated header")));
+    }
+    model.problemsUpdated(header);
+
+    // the problem that the source reports in the header is kept
+    QTRY_COMPARE_WITH_TIMEOUT(descriptions(model.store()->problems(header)),
+                              QStringList({QStringLiteral("source in header"), QStringLiteral("updated header")}),
+                              10000);
+    QCOMPARE(descriptions(model.store()->problems(source)), QStringList({QStringLiteral("source")}));
+
+    DUChainWriteLocker lock;
+    DUChain::self()->removeDocumentChain(sourceContext);
+    DUChain::self()->removeDocumentChain(headerContext);
+}
+
+QTEST_MAIN(TestProblemReporterModel)
+
+#include "test_problemreportermodel.moc"